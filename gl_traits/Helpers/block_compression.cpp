@@ -0,0 +1,260 @@
+#include "block_compression.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HELPERS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	struct rgba
+	{
+		uint8_t c[4];
+	};
+
+	// 4x4 texels in rows
+	struct block
+	{
+		alignas(16) rgba texels[16];
+	};
+
+	void FetchBlock(block& b, const unsigned char* pixels, int width, int height, int channels,
+		int x0, int y0)
+	{
+		for (int y = 0; y != 4; ++y)
+			for (int x = 0; x != 4; ++x)
+			{
+				const unsigned char* p = pixels + ((size_t)std::min(y0 + y, height - 1) * width +
+					std::min(x0 + x, width - 1)) * channels;
+
+				uint8_t* t = b.texels[y * 4 + x].c;
+				switch (channels)
+				{
+				case 1:
+					t[0] = t[1] = t[2] = p[0];
+					t[3] = 255;
+					break;
+				case 2:
+					t[0] = p[0];
+					t[1] = p[1];
+					t[2] = 0;
+					t[3] = 255;
+					break;
+				case 3:
+					t[0] = p[0];
+					t[1] = p[1];
+					t[2] = p[2];
+					t[3] = 255;
+					break;
+				default:
+					std::memcpy(t, p, 4);
+					break;
+				}
+			}
+	}
+
+	// per channel minimum and maximum of the block
+	void BoundingBox(const block& b, rgba& mn, rgba& mx)
+	{
+#ifdef HELPERS_SSE2
+		const __m128i* t = reinterpret_cast<const __m128i*>(b.texels);
+		__m128i t0 = _mm_load_si128(t),
+			t1 = _mm_load_si128(t + 1),
+			t2 = _mm_load_si128(t + 2),
+			t3 = _mm_load_si128(t + 3);
+
+		__m128i lo = _mm_min_epu8(_mm_min_epu8(t0, t1), _mm_min_epu8(t2, t3)),
+			hi = _mm_max_epu8(_mm_max_epu8(t0, t1), _mm_max_epu8(t2, t3));
+
+		// 4 texels of a register to 1
+		lo = _mm_min_epu8(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)));
+		lo = _mm_min_epu8(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+		hi = _mm_max_epu8(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(1, 0, 3, 2)));
+		hi = _mm_max_epu8(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		uint32_t l = (uint32_t)_mm_cvtsi128_si32(lo),
+			h = (uint32_t)_mm_cvtsi128_si32(hi);
+		std::memcpy(mn.c, &l, 4);
+		std::memcpy(mx.c, &h, 4);
+#else
+		mn = mx = b.texels[0];
+		for (const rgba& t : b.texels)
+			for (int i = 0; i != 4; ++i)
+			{
+				mn.c[i] = std::min(mn.c[i], t.c[i]);
+				mx.c[i] = std::max(mx.c[i], t.c[i]);
+			}
+#endif
+	}
+
+	uint16_t To565(const rgba& c)
+	{
+		return (uint16_t)((c.c[0] * 31 + 127) / 255 << 11 |
+			(c.c[1] * 63 + 127) / 255 << 5 |
+			(c.c[2] * 31 + 127) / 255);
+	}
+
+	void From565(uint16_t c, int* rgb)
+	{
+		int r = c >> 11 & 31,
+			g = c >> 5 & 63,
+			b = c & 31;
+
+		rgb[0] = r << 3 | r >> 2;
+		rgb[1] = g << 2 | g >> 4;
+		rgb[2] = b << 3 | b >> 2;
+	}
+
+	void Write(uint8_t* out, uint64_t val, int bytes)
+	{
+		for (int i = 0; i != bytes; ++i)
+			out[i] = (uint8_t)(val >> (8 * i));
+	}
+
+	// BC1 color block, 4 color mode
+	void EncodeColor(const block& b, rgba mn, rgba mx, uint8_t* out)
+	{
+		for (int i = 0; i != 3; ++i)
+		{
+			int inset = (mx.c[i] - mn.c[i]) >> 4;
+			mn.c[i] = (uint8_t)(mn.c[i] + inset);
+			mx.c[i] = (uint8_t)(mx.c[i] - inset);
+		}
+
+		// bounding box diagonal following the correlation of green and blue with red
+		int center[3], cov[3]{};
+		for (int i = 0; i != 3; ++i)
+			center[i] = (mn.c[i] + mx.c[i]) / 2;
+
+		for (const rgba& t : b.texels)
+			for (int i = 1; i != 3; ++i)
+				cov[i] += (t.c[0] - center[0]) * (t.c[i] - center[i]);
+
+		for (int i = 1; i != 3; ++i)
+			if (cov[i] < 0)
+				std::swap(mn.c[i], mx.c[i]);
+
+		uint16_t c0 = To565(mx),
+			c1 = To565(mn);
+		if (c0 < c1)
+			std::swap(c0, c1);
+
+		uint32_t indices = 0;
+		if (c0 != c1)
+		{
+			int palette[4][3];
+			From565(c0, palette[0]);
+			From565(c1, palette[1]);
+			for (int i = 0; i != 3; ++i)
+			{
+				palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+				palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+			}
+
+			for (int t = 0; t != 16; ++t)
+			{
+				const uint8_t* c = b.texels[t].c;
+
+				uint32_t best = 0;
+				int bestDist = INT32_MAX;
+				for (uint32_t p = 0; p != 4; ++p)
+				{
+					int dr = c[0] - palette[p][0],
+						dg = c[1] - palette[p][1],
+						db = c[2] - palette[p][2],
+						dist = dr * dr + dg * dg + db * db;
+
+					if (dist < bestDist)
+					{
+						bestDist = dist;
+						best = p;
+					}
+				}
+
+				indices |= best << (2 * t);
+			}
+		}
+
+		Write(out, c0, 2);
+		Write(out + 2, c1, 2);
+		Write(out + 4, indices, 4);
+	}
+
+	// BC4 block of a single channel, 8 values mode
+	void EncodeChannel(const block& b, int channel, uint8_t mn, uint8_t mx, uint8_t* out)
+	{
+		uint64_t indices = 0;
+		int range = mx - mn;
+
+		if (range)
+			for (int t = 0; t != 16; ++t)
+			{
+				// position between the endpoints: 0 - max, 7 - min
+				int pos = ((mx - b.texels[t].c[channel]) * 7 + range / 2) / range;
+				uint64_t indx = pos == 0 ? 0 : (pos == 7 ? 1 : (uint64_t)pos + 1);
+
+				indices |= indx << (3 * t);
+			}
+
+		out[0] = mx;
+		out[1] = mn;
+		Write(out + 2, indices, 6);
+	}
+}
+
+size_t BlockBytes(BlockFormat format)
+{
+	return format == BlockFormat::bc1 || format == BlockFormat::bc4 ? 8 : 16;
+}
+
+std::vector<unsigned char> CompressBlocks(BlockFormat format, const unsigned char* pixels,
+	int width, int height, int channels)
+{
+	assert(pixels && width > 0 && height > 0 && channels > 0 && channels <= 4 &&
+		"Invalid image for block compression!");
+
+	size_t blockBytes = BlockBytes(format);
+	std::vector<unsigned char> out((size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes);
+
+	uint8_t* dst = out.data();
+	block b;
+	rgba mn, mx;
+
+	for (int y = 0; y < height; y += 4)
+		for (int x = 0; x < width; x += 4, dst += blockBytes)
+		{
+			FetchBlock(b, pixels, width, height, channels, x, y);
+			BoundingBox(b, mn, mx);
+
+			switch (format)
+			{
+			case BlockFormat::bc1:
+				EncodeColor(b, mn, mx, dst);
+				break;
+			case BlockFormat::bc3:
+				EncodeChannel(b, 3, mn.c[3], mx.c[3], dst);
+				EncodeColor(b, mn, mx, dst + 8);
+				break;
+			case BlockFormat::bc4:
+				EncodeChannel(b, 0, mn.c[0], mx.c[0], dst);
+				break;
+			case BlockFormat::bc5:
+				EncodeChannel(b, 0, mn.c[0], mx.c[0], dst);
+				EncodeChannel(b, 1, mn.c[1], mx.c[1], dst + 8);
+				break;
+			}
+		}
+
+	return out;
+}
+
+std::vector<unsigned char> CompressBlocks(BlockFormat format, const Image& image)
+{
+	return CompressBlocks(format, image.Data(), image.Width(), image.Height(), image.NumChannels());
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/*
+CPU block compression of 8-bit images to BC1, BC3, BC4 and BC5 (4x4 texel blocks).
+
+Endpoints are the bounding box of a block inset by 1/16 of its range (BC1 colors),
+texels are matched to the nearest value of the palette. Bounding boxes are computed
+with SSE2 when available. The quality is that of a real-time encoder, fast enough to
+compress textures when they are loaded or to bake them offline.
+*/
+
+#include <cstddef>
+#include <vector>
+
+class Image;
+
+enum class BlockFormat
+{
+	bc1,	// rgb, 8 bytes per block
+	bc3,	// rgba, 16 bytes per block
+	bc4,	// red, 8 bytes per block
+	bc5		// red and green, 16 bytes per block
+};
+
+size_t BlockBytes(BlockFormat format);
+
+/*
+pixels - rows of width * channels bytes:
+1 - grey, 2 - red and green, 3 - rgb, 4 - rgba;
+Blocks are stored in rows, partial blocks at the edges repeat the edge texels.
+*/
+std::vector<unsigned char> CompressBlocks(BlockFormat format, const unsigned char* pixels,
+	int width, int height, int channels);
+
+std::vector<unsigned char> CompressBlocks(BlockFormat format, const Image& image);
@@ -43,8 +43,9 @@ SmartGLFW::~SmartGLFW()
 	glfwTerminate();
 }
 
-SmartGLFWwindow::SmartGLFWwindow(unsigned int width, unsigned int height, const std::string & title)
-	: window_(glfwCreateWindow(width, height, title.data(), nullptr, nullptr)),
+SmartGLFWwindow::SmartGLFWwindow(unsigned int width, unsigned int height, const std::string & title,
+	GLFWwindow* share)
+	: window_(glfwCreateWindow(width, height, title.data(), nullptr, share)),
     width_(width),
     height_(height)
 {
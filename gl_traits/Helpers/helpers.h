@@ -42,8 +42,9 @@ class SmartGLFWwindow
         height_;
 
 public:
+	// share - window whose context shares objects with the created one
 	SmartGLFWwindow(unsigned int width, unsigned int height,
-		const std::string& title);
+		const std::string& title, GLFWwindow* share = nullptr);
 
 	operator GLFWwindow*() const;
 
@@ -0,0 +1,457 @@
+#include "mip_generation.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HELPERS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr float pi = 3.14159265358979f;
+
+	// radius of Kaiser and Lanczos filters in texels of the destination level
+	constexpr float filterWidth = 3.f;
+
+	float Sinc(float x)
+	{
+		if (std::abs(x) < 1e-5f)
+			return 1.f;
+
+		x *= pi;
+		return std::sin(x) / x;
+	}
+
+	// modified Bessel function of the first kind of order 0
+	float BesselI0(float x)
+	{
+		float sum = 1.f,
+			term = 1.f;
+
+		for (int k = 1; k != 20; ++k)
+		{
+			float f = x / (2.f * k);
+			term *= f * f;
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	float Kernel(MipFilter filter, float t)
+	{
+		t = std::abs(t);
+
+		switch (filter)
+		{
+		case MipFilter::box:
+			return t <= 0.5f ? 1.f : 0.f;
+		case MipFilter::kaiser:
+		{
+			if (t >= filterWidth)
+				return 0.f;
+
+			constexpr float alpha = 4.f;
+			float r = t / filterWidth;
+			return Sinc(t) * BesselI0(alpha * std::sqrt(1.f - r * r)) / BesselI0(alpha);
+		}
+		case MipFilter::lanczos:
+			return t < filterWidth ? Sinc(t) * Sinc(t / filterWidth) : 0.f;
+		}
+
+		return 0.f;
+	}
+
+	// source texels contributing to a texel of the destination, clamped to the edges
+	struct taps
+	{
+		std::vector<int> indices;
+		std::vector<float> weights;
+	};
+
+	std::vector<taps> FilterTaps(MipFilter filter, int src, int dst)
+	{
+		float scale = (float)src / dst,
+			support = (filter == MipFilter::box ? 0.5f : filterWidth) * scale;
+
+		std::vector<taps> out(dst);
+		for (int x = 0; x != dst; ++x)
+		{
+			taps& t = out[x];
+			float center = (x + 0.5f) * scale,
+				sum = 0.f;
+
+			for (int i = (int)std::floor(center - support); i <= (int)std::ceil(center + support); ++i)
+			{
+				float w = Kernel(filter, (i + 0.5f - center) / scale);
+				if (w == 0.f)
+					continue;
+
+				t.indices.push_back(std::clamp(i, 0, src - 1));
+				t.weights.push_back(w);
+				sum += w;
+			}
+
+			for (float& w : t.weights)
+				w /= sum;
+		}
+
+		return out;
+	}
+
+	float SrgbToLinear(float c)
+	{
+		return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float LinearToSrgb(float c)
+	{
+		return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+	}
+
+	struct srgb_tables
+	{
+		static constexpr int encodeSize = 1 << 14;
+
+		float decode[256];
+		uint8_t encode[encodeSize];
+
+		srgb_tables()
+		{
+			for (int i = 0; i != 256; ++i)
+				decode[i] = SrgbToLinear(i / 255.f);
+
+			for (int i = 0; i != encodeSize; ++i)
+				encode[i] = (uint8_t)(LinearToSrgb((float)i / (encodeSize - 1)) * 255.f + 0.5f);
+		}
+	};
+
+	const srgb_tables& SrgbTables()
+	{
+		static const srgb_tables tables;
+		return tables;
+	}
+
+	// alpha of grey-alpha and rgba images is linear
+	bool IsColor(size_t channel, int channels)
+	{
+		return !((channels == 2 || channels == 4) && channel == (size_t)channels - 1);
+	}
+
+	struct float_level
+	{
+		int width,
+			height;
+		std::vector<float> texels;
+	};
+
+	float_level ToFloat(const unsigned char* pixels, int width, int height, int channels, bool srgb)
+	{
+		const srgb_tables& tables = SrgbTables();
+
+		float_level level{ width, height, std::vector<float>((size_t)width * height * channels) };
+		for (size_t i = 0; i != level.texels.size(); ++i)
+			level.texels[i] = srgb && IsColor(i % channels, channels) ?
+				tables.decode[pixels[i]] : pixels[i] / 255.f;
+
+		return level;
+	}
+
+	void ToBytes(const float_level& level, int channels, bool srgb, std::vector<unsigned char>& out)
+	{
+		const srgb_tables& tables = SrgbTables();
+
+		out.resize(level.texels.size());
+		for (size_t i = 0; i != level.texels.size(); ++i)
+		{
+			float v = std::clamp(level.texels[i], 0.f, 1.f);
+			out[i] = srgb && IsColor(i % channels, channels) ?
+				tables.encode[(int)(v * (srgb_tables::encodeSize - 1) + 0.5f)] :
+				(unsigned char)(v * 255.f + 0.5f);
+		}
+	}
+
+	// separable filter, rows then columns
+	float_level Downsample(const float_level& src, int channels, MipFilter filter)
+	{
+		int width = std::max(1, src.width / 2),
+			height = std::max(1, src.height / 2);
+
+		std::vector<taps> tapsX = FilterTaps(filter, src.width, width),
+			tapsY = FilterTaps(filter, src.height, height);
+
+		size_t rowFloats = (size_t)width * channels;
+		std::vector<float> rows(rowFloats * src.height);
+
+		for (int y = 0; y != src.height; ++y)
+		{
+			const float* in = src.texels.data() + (size_t)y * src.width * channels;
+			float* out = rows.data() + y * rowFloats;
+
+			for (int x = 0; x != width; ++x, out += channels)
+			{
+				const taps& t = tapsX[x];
+#ifdef HELPERS_SSE2
+				if (channels == 4)
+				{
+					__m128 acc = _mm_setzero_ps();
+					for (size_t i = 0; i != t.indices.size(); ++i)
+						acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(t.weights[i]),
+							_mm_loadu_ps(in + (size_t)t.indices[i] * 4)));
+
+					_mm_storeu_ps(out, acc);
+					continue;
+				}
+#endif
+				std::fill(out, out + channels, 0.f);
+				for (size_t i = 0; i != t.indices.size(); ++i)
+					for (int c = 0; c != channels; ++c)
+						out[c] += t.weights[i] * in[(size_t)t.indices[i] * channels + c];
+			}
+		}
+
+		float_level dst{ width, height, std::vector<float>(rowFloats * height) };
+		for (int y = 0; y != height; ++y)
+		{
+			const taps& t = tapsY[y];
+			float* out = dst.texels.data() + y * rowFloats;
+
+			for (size_t i = 0; i != t.indices.size(); ++i)
+			{
+				const float* in = rows.data() + t.indices[i] * rowFloats;
+				float w = t.weights[i];
+
+				size_t f = 0;
+#ifdef HELPERS_SSE2
+				__m128 weight = _mm_set1_ps(w);
+				for (; f + 4 <= rowFloats; f += 4)
+					_mm_storeu_ps(out + f, _mm_add_ps(_mm_loadu_ps(out + f),
+						_mm_mul_ps(weight, _mm_loadu_ps(in + f))));
+#endif
+				for (; f != rowFloats; ++f)
+					out[f] += w * in[f];
+			}
+		}
+
+		return dst;
+	}
+
+	// average of 2x2 texels of 8-bit channels
+	void DownsampleBox(const MipLevel& src, int channels, MipLevel& dst)
+	{
+		dst.width = std::max(1, src.width / 2);
+		dst.height = std::max(1, src.height / 2);
+		dst.pixels.resize((size_t)dst.width * dst.height * channels);
+
+		size_t srcRow = (size_t)src.width * channels;
+
+		for (int y = 0; y != dst.height; ++y)
+		{
+			const uint8_t* r0 = src.pixels.data() + std::min(2 * y, src.height - 1) * srcRow,
+				*r1 = src.pixels.data() + std::min(2 * y + 1, src.height - 1) * srcRow;
+			uint8_t* out = dst.pixels.data() + (size_t)y * dst.width * channels;
+
+			int x = 0;
+#ifdef HELPERS_SSE2
+			if (channels == 4)
+			{
+				const __m128i zero = _mm_setzero_si128(),
+					two = _mm_set1_epi16(2);
+
+				// 4 texels of both rows to 2 texels
+				for (; 2 * x + 3 < src.width; x += 2)
+				{
+					__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + 8 * x)),
+						b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + 8 * x));
+
+					__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+						hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+					// neighbour texels of a register summed in its low half
+					lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+					hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+					__m128i avg = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4 * x), _mm_packus_epi16(avg, zero));
+				}
+			}
+#endif
+			for (; x != dst.width; ++x)
+			{
+				size_t x0 = (size_t)std::min(2 * x, src.width - 1) * channels,
+					x1 = (size_t)std::min(2 * x + 1, src.width - 1) * channels;
+
+				for (int c = 0; c != channels; ++c)
+					out[(size_t)x * channels + c] =
+						(uint8_t)((r0[x0 + c] + r0[x1 + c] + r1[x0 + c] + r1[x1 + c] + 2) >> 2);
+			}
+		}
+	}
+
+	constexpr char cacheMagic[4]{ 'M', 'I', 'P', 'S' };
+	constexpr int32_t cacheVersion = 1;
+
+	template <typename T>
+	void WriteValue(std::ostream& out, T val)
+	{
+		out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+	}
+
+	template <typename T>
+	bool ReadValue(std::istream& in, T& val)
+	{
+		return (bool)in.read(reinterpret_cast<char*>(&val), sizeof(T));
+	}
+}
+
+std::vector<const void*> MipChain::Pixels() const
+{
+	std::vector<const void*> pixels;
+	pixels.reserve(levels.size());
+
+	for (const MipLevel& level : levels)
+		pixels.push_back(level.pixels.data());
+
+	return pixels;
+}
+
+MipChain GenerateMipChain(const unsigned char* pixels, int width, int height, int channels,
+	MipFilter filter, bool srgb)
+{
+	assert(pixels && width > 0 && height > 0 && channels > 0 && channels <= 4 &&
+		"Invalid image for mip generation!");
+
+	MipChain chain;
+	chain.channels = channels;
+	chain.levels.push_back(MipLevel{ width, height,
+		std::vector<unsigned char>(pixels, pixels + (size_t)width * height * channels) });
+
+	if (filter == MipFilter::box && !srgb)
+	{
+		while (chain.levels.back().width > 1 || chain.levels.back().height > 1)
+		{
+			MipLevel next;
+			DownsampleBox(chain.levels.back(), channels, next);
+			chain.levels.push_back(std::move(next));
+		}
+
+		return chain;
+	}
+
+	// levels are filtered from the previous one before quantization
+	float_level level = ToFloat(pixels, width, height, channels, srgb);
+	while (level.width > 1 || level.height > 1)
+	{
+		level = Downsample(level, channels, filter);
+
+		MipLevel next{ level.width, level.height, {} };
+		ToBytes(level, channels, srgb, next.pixels);
+		chain.levels.push_back(std::move(next));
+	}
+
+	return chain;
+}
+
+MipChain GenerateMipChain(const Image& image, MipFilter filter, bool srgb)
+{
+	return GenerateMipChain(image.Data(), image.Width(), image.Height(), image.NumChannels(),
+		filter, srgb);
+}
+
+bool SaveMipChain(const std::filesystem::path& file, const MipChain& chain,
+	MipFilter filter, bool srgb)
+{
+	if (chain.levels.empty())
+		return false;
+
+	std::ofstream out(file, std::ios::binary);
+	if (!out)
+		return false;
+
+	out.write(cacheMagic, sizeof(cacheMagic));
+	WriteValue<int32_t>(out, cacheVersion);
+	WriteValue<int32_t>(out, chain.channels);
+	WriteValue<int32_t>(out, (int32_t)filter);
+	WriteValue<int32_t>(out, srgb);
+	WriteValue<int32_t>(out, (int32_t)chain.levels.size());
+
+	for (const MipLevel& level : chain.levels)
+	{
+		WriteValue<int32_t>(out, level.width);
+		WriteValue<int32_t>(out, level.height);
+		out.write(reinterpret_cast<const char*>(level.pixels.data()), level.pixels.size());
+	}
+
+	return (bool)out;
+}
+
+MipChain LoadMipChain(const std::filesystem::path& file, MipFilter filter, bool srgb)
+{
+	std::ifstream in(file, std::ios::binary);
+
+	char magic[4];
+	int32_t version, channels, cachedFilter, cachedSrgb, count;
+
+	if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, cacheMagic, sizeof(magic)) ||
+		!ReadValue(in, version) || !ReadValue(in, channels) || !ReadValue(in, cachedFilter) ||
+		!ReadValue(in, cachedSrgb) || !ReadValue(in, count))
+		return {};
+
+	if (version != cacheVersion || channels < 1 || channels > 4 || count < 1 ||
+		cachedFilter != (int32_t)filter || (bool)cachedSrgb != srgb)
+		return {};
+
+	MipChain chain;
+	chain.channels = channels;
+
+	for (int32_t i = 0; i != count; ++i)
+	{
+		int32_t width, height;
+		if (!ReadValue(in, width) || !ReadValue(in, height) || width < 1 || height < 1)
+			return {};
+
+		MipLevel level{ width, height, std::vector<unsigned char>((size_t)width * height * channels) };
+		if (!in.read(reinterpret_cast<char*>(level.pixels.data()), level.pixels.size()))
+			return {};
+
+		chain.levels.push_back(std::move(level));
+	}
+
+	return chain;
+}
+
+MipChain CachedMipChain(const std::filesystem::path& image, MipFilter filter, bool srgb)
+{
+	std::filesystem::path cache = image;
+	cache += ".mips";
+
+	std::error_code ec;
+	std::filesystem::file_time_type imageTime = std::filesystem::last_write_time(image, ec);
+	if (ec)
+		return {};
+
+	std::filesystem::file_time_type cacheTime = std::filesystem::last_write_time(cache, ec);
+	if (!ec && cacheTime >= imageTime)
+	{
+		MipChain chain = LoadMipChain(cache, filter, srgb);
+		if (!chain.levels.empty())
+			return chain;
+	}
+
+	Image im{ image };
+	if (!im.Data())
+		return {};
+
+	MipChain chain = GenerateMipChain(im, filter, srgb);
+
+	// failing to cache the chain is not an error
+	SaveMipChain(cache, chain, filter, srgb);
+	return chain;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+/*
+CPU generation of mip chains of 8-bit images, instead of glGenerateMipmap.
+
+Each level halves the previous one down to 1x1. Box filter averages 2x2 texels (SSE2
+when available), Kaiser and Lanczos filters are separable windowed sincs of 3 texels
+of the level, sharper than the box. Levels are filtered in linear floats from the
+previous level, colors are decoded from sRGB when srgb is set (alpha is linear).
+Generation does not call OpenGL, thus chains may be computed by worker threads and
+uploaded with Texture::SetMipChain.
+*/
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+class Image;
+
+enum class MipFilter
+{
+	box,
+	kaiser,
+	lanczos
+};
+
+struct MipLevel
+{
+	int width = 0,
+		height = 0;
+	std::vector<unsigned char> pixels;
+};
+
+struct MipChain
+{
+	// 1 - grey, 2 - grey and alpha, 3 - rgb, 4 - rgba
+	int channels = 0;
+
+	// level 0 is the image, empty - failed to load
+	std::vector<MipLevel> levels;
+
+	// pixels of the levels for Texture::SetMipChain
+	std::vector<const void*> Pixels() const;
+};
+
+MipChain GenerateMipChain(const unsigned char* pixels, int width, int height, int channels,
+	MipFilter filter = MipFilter::box, bool srgb = false);
+
+MipChain GenerateMipChain(const Image& image, MipFilter filter = MipFilter::box, bool srgb = false);
+
+bool SaveMipChain(const std::filesystem::path& file, const MipChain& chain,
+	MipFilter filter, bool srgb);
+
+// empty if the file is missing, invalid or generated with another filter
+MipChain LoadMipChain(const std::filesystem::path& file, MipFilter filter, bool srgb);
+
+/*
+Chain of the image cached alongside it in "<image>.mips",
+the chain is generated and saved when the cache is missing or older than the image.
+*/
+MipChain CachedMipChain(const std::filesystem::path& image,
+	MipFilter filter = MipFilter::box, bool srgb = false);
@@ -116,11 +116,17 @@ int main(int argc, char * argv[])
 
 	vao.EnablePointers();
 
-	glEnable(GL_DEPTH_TEST);
+	glt::Enable(glt::Capability::depth_test);
 
     glt::Texture2D<glt::TexInternFormat::rgba> texture1,
         texture2;
 
+    // both textures are sampled with the same sampler object
+    glt::SamplerCache samplers;
+
+    glt::SamplerState linearRepeat;
+    linearRepeat.minFilter = glt::TexFilter::linear;
+
     // TODO: load one of the textures using glt Buffer
     {
         Image tex1{ exePath.parent_path().append("resources/textures/container.jpg").generic_string() },
@@ -128,15 +134,9 @@ int main(int argc, char * argv[])
 
         assert(tex1.Data() && tex2.Data());
 
-        glActiveTexture(GL_TEXTURE0);
+        glt::ActiveTexture(0);
         texture1.Bind();
-
-        // set the texture wrapping parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        // set texture filtering parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        samplers.Bind(0, linearRepeat);
 
         texture1.SetImage(0, tex1.Width(), tex1.Height());
         texture1.SubImage(0, tex1.Width(), tex1.Height(), glt::TexFormat::rgb,
@@ -145,15 +145,9 @@ int main(int argc, char * argv[])
         texture1.GenerateMipMap();
 
 
-        glActiveTexture(GL_TEXTURE1);
+        glt::ActiveTexture(1);
         texture2.Bind();
-
-        // set the texture wrapping parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        // set texture filtering parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        samplers.Bind(1, linearRepeat);
 
         texture2.SetImage(0, tex2.Width(), tex2.Height());
         texture2.SubImage(0, tex2.Width(), tex2.Height(), glt::TexFormat::rgba,
@@ -161,8 +155,7 @@ int main(int argc, char * argv[])
 
         texture2.GenerateMipMap();
 
-        glActiveTexture(GL_TEXTURE3);
-        texture2.UnBind();
+        // textures stay bound to units 0 and 1 for drawing
     }
 
     prog.Use();
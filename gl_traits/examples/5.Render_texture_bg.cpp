@@ -90,17 +90,25 @@ int main(int argc, const char** argv)
     vao.AttributePointer(glt::tag_s<0>(), buf_bg_tex_coord()());
     vao.EnablePointers();
 
-    glEnable(GL_DEPTH_TEST);
+    glt::Enable(glt::Capability::depth_test);
 
 	glt::Texture2D<glt::TexInternFormat::rgba> tex;
 
+	// the background is stretched over the screen, thus edges are not repeated
+	glt::SamplerCache samplers;
+
+	glt::SamplerState linearClamp;
+	linearClamp.minFilter = glt::TexFilter::linear_mipmap_linear;
+	linearClamp.wrapS = linearClamp.wrapT = glt::TexWrap::clamp_to_edge;
+
 	{
 		Image bgIm{ exePath.parent_path().append("resources/textures/waves.jpg") };
 
 		assert(bgIm.Data() && "Failed to load the texture!");
 
-		glActiveTexture(GL_TEXTURE0);
+		glt::ActiveTexture(0);
 		tex.Bind();
+		samplers.Bind(0, linearClamp);
 
 		tex.SetImage(0, bgIm.Width(), bgIm.Height());
 
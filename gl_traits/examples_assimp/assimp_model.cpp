@@ -2,6 +2,9 @@
 
 #include "assimp_model_impl.h"
 
+#include <fstream>
+#include <iterator>
+
 
 glt::TexFormat translate_texture_format(const Image & im)
 {
@@ -24,9 +27,53 @@ glt::TexFormat translate_texture_format(const Image & im)
 	}
 }
 
+// mip chains are cached alongside the images
+glt::DecodedImage decode_texture(const std::string& path, bool srgb)
+{
+	MipChain chain = CachedMipChain(path, MipFilter::kaiser, srgb);
+
+	glt::DecodedImage decoded;
+	if (chain.levels.empty())
+		return decoded;
+
+	switch (chain.channels)
+	{
+	case 3:
+		decoded.format = glt::TexFormat::rgb;
+		break;
+	case 4:
+		decoded.format = glt::TexFormat::rgba;
+		break;
+	default:
+		// this case should be handled inside a frag shader
+		assert(false && "Unhandled case");
+		return decoded;
+	}
+
+	decoded.width = chain.levels[0].width;
+	decoded.height = chain.levels[0].height;
+	decoded.pixels = std::move(chain.levels[0].pixels);
+
+	for (size_t i = 1; i != chain.levels.size(); ++i)
+		decoded.mips.push_back(std::move(chain.levels[i].pixels));
+
+	return decoded;
+}
+
 
 TexturesCached Model::cached_textures_{};
 
+namespace
+{
+	// trilinear filtering of the mip chains
+	const glt::SamplerState diffuse_sampler = []()
+	{
+		glt::SamplerState state;
+		state.minFilter = glt::TexFilter::linear_mipmap_linear;
+		return state;
+	}();
+}
+
 Model::Model(const fsys::path & path)
 	: path_(path)
 {
@@ -47,17 +94,15 @@ void Model::Draw(ProgModel::ProgGuard & pg)
 			continue;
 		}
 
-		std::optional<RefTexture2Drgba> refTexture =
-			cached_textures_.FindTexture(
-				mat.tex_refs_.RefPath(glt::tag_v<aiTextureType_DIFFUSE>(), 0));
-
-		assert(refTexture && "Texture is not cached!");
-		glt::Texture2Drgba& texture = *refTexture;
+		glt::Texture2Drgba texture = cached_textures_.GetTexture(
+			mat.tex_refs_.RefPath(glt::tag_v<aiTextureType_DIFFUSE>(), 0),
+			is_srgb_texture(aiTextureType_DIFFUSE));
 
-		glActiveTexture(GL_TEXTURE0);
+		glt::ActiveTexture(0);
 		pg.Uniforms().Set(texture_diffuse_sampler2D{ 0 });
 
 		texture.Bind();
+		cached_textures_.samplers_.Bind(0, diffuse_sampler);
 
 		m.Draw(pg);
 
@@ -89,15 +134,34 @@ void Model::LoadModelMesh(Model& model, const aiScene& scene)
 
 }
 
-std::optional<RefTexture2Drgba> TexturesCached::FindTexture(fsys::path p)
+glt::TextureKey TexturesCached::Key(const fsys::path& p, bool srgb)
 {
-	std::map<fsys::path, glt::Texture2Drgba>::iterator found =
-		textures_.find(p);
+	auto srgbKey = [srgb](glt::TextureKey key)
+	{
+		if (srgb)
+			key.hash = glt::HashString("srgb", key.hash);
+		return key;
+	};
+
+	std::map<fsys::path, glt::TextureKey>::iterator found = keys_.find(p);
+	if (found != keys_.cend())
+		return srgbKey(found->second);
+
+	// missing files are keyed by their path
+	std::ifstream file{ p, std::ios::binary };
+	std::vector<char> bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
 
-	if (found == textures_.cend())
-		return std::nullopt;
+	glt::TextureKey key = bytes.empty() ?
+		glt::TextureKey{ glt::HashString(p.generic_string()), 0 } :
+		glt::TextureKey{ glt::HashBytes(bytes.data(), bytes.size()), bytes.size() };
 
-	return RefTexture2Drgba(found->second);
+	keys_.emplace(p, key);
+	return srgbKey(key);
+}
+
+std::optional<glt::Texture2Drgba> TexturesCached::FindTexture(fsys::path p, bool srgb)
+{
+	return cache_.Find(Key(p, srgb));
 }
 
 Mesh::Mesh(const aiMesh& mesh)
@@ -128,6 +192,7 @@ Mesh::Mesh(const aiMesh& mesh)
 	bufMesh.UnBind();
 
 	vao.EnablePointers();
+	vao.BindElementBuffer(bufElems);
 	vao.UnBind();
 	
 	assert(glt::AssertGL());
@@ -147,6 +212,6 @@ void Mesh::Draw(ProgModel::ProgGuard & pg)
 {
 	// TODO: setup textures?
 	vao.Bind();
-	pg.DrawElements(bufElems, glt::RenderMode::triangles, bufElems().Allocated());
+	pg.DrawElements(vao, glt::RenderMode::triangles, vao.ElementCount());
 	vao.UnBind();
 }
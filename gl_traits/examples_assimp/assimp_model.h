@@ -3,6 +3,7 @@
 #include "glt_Common.h"
 
 #include "helpers.h"
+#include "mip_generation.h"
 
 using Uniforms = glt::uniform_collection<std::tuple<model_mat4,
 	view_mat4,
@@ -16,12 +17,11 @@ using BufferMesh = glt::Buffer<VertexData>;
 using BufferElems = glt::Buffer<unsigned int>;
 using BufferTexture = glt::Buffer<unsigned char>;
 
-using RefTexture2Drgba = std::reference_wrapper<glt::Texture2Drgba>;
-
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"
 #include "assimp/postprocess.h"
 
+#include <memory>
 #include <numeric>
 #include <optional>
 
@@ -31,6 +31,15 @@ using RefTexture2Drgba = std::reference_wrapper<glt::Texture2Drgba>;
 
 glt::TexFormat translate_texture_format(const Image & im);
 
+// invoked by the workers of the texture loaders, srgb - colors are filtered in linear space
+glt::DecodedImage decode_texture(const std::string& path, bool srgb);
+
+// colors of diffuse and emissive textures are sRGB, other textures hold linear data
+constexpr bool is_srgb_texture(aiTextureType type)
+{
+	return type == aiTextureType_DIFFUSE || type == aiTextureType_EMISSIVE;
+}
+
 
 template <aiTextureType ... types>
 class types_list
@@ -55,35 +64,54 @@ private:
 };
 
 
-// TODO: use hash for path
+// textures are deduplicated by the hash of their files
 struct TexturesCached
 {
-	std::map<fsys::path, glt::Texture2Drgba> textures_;
+	glt::TextureCache<glt::TexInternFormat::rgba> cache_{ 256 << 20 };
 
-	std::optional<RefTexture2Drgba> FindTexture(fsys::path p);
+	// files are hashed once
+	std::map<fsys::path, glt::TextureKey> keys_;
 
-	glt::Texture2Drgba& GetTexture(fsys::path p)
-	{
-		std::optional<RefTexture2Drgba> loaded = FindTexture(p);
-		if (loaded)
-			return *loaded;
+	// created with the first texture, when the context is current
+	std::unique_ptr<glt::TextureLoader<glt::TexInternFormat::rgba>> loader_,
+		srgbLoader_;
 
-		Image im{ p };
+	// textures are sampled with the shared samplers
+	glt::SamplerCache samplers_;
 
-		glt::Texture2Drgba tex;
-		tex.Bind();
+	// the same file is a different texture when sampled as sRGB
+	glt::TextureKey Key(const fsys::path& p, bool srgb);
 
-		tex.SetImage(0, im.Width(), im.Height());
-		tex.SubImage(0, im.Width(), im.Height(), translate_texture_format(im),
-			glt::TexType::unsigned_byte, im.Data());
+	std::optional<glt::Texture2Drgba> FindTexture(fsys::path p, bool srgb);
 
-		tex.GenerateMipMap();
-		tex.UnBind();
+	// returns a texture object sharing the cached texture, evicted textures are loaded again,
+	// the texture holds a placeholder until its image is decoded and uploaded
+	glt::Texture2Drgba GetTexture(fsys::path p, bool srgb)
+	{
+		return cache_.Get(Key(p, srgb), [&]()
+		{
+			std::unique_ptr<glt::TextureLoader<glt::TexInternFormat::rgba>>& loader =
+				srgb ? srgbLoader_ : loader_;
 
-		auto emplaced = textures_.emplace(std::make_pair(p, std::move(tex)));
+			if (!loader)
+				loader = std::make_unique<glt::TextureLoader<glt::TexInternFormat::rgba>>(
+					[srgb](const std::string& path) { return decode_texture(path, srgb); });
 
-		glt::Texture2Drgba& out = emplaced.first->second;
-		return out;
+			return loader->Load(p.string());
+		});
+	}
+
+	// uploads decoded images, called every frame
+	void Upload(size_t budgetBytes)
+	{
+		size_t uploaded = 0;
+		if (loader_)
+			uploaded += loader_->Upload(budgetBytes);
+		if (srgbLoader_)
+			uploaded += srgbLoader_->Upload(budgetBytes);
+
+		if (uploaded)
+			cache_.Trim();
 	}
 
 };
@@ -179,7 +207,7 @@ private:
 			fsys::path p{ absFolder };
 			p.append(path.C_Str());
 
-			cached.GetTexture(p);
+			cached.GetTexture(p, is_srgb_texture(type));
 
 			tex_refs_.AppendRef(glt::tag_v<type>(), std::move(p));
 		}
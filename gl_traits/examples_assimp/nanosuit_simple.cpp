@@ -29,7 +29,7 @@ int main(int argc, const char **argv)
     glfw.MakeContextCurrent(window);
     glt::LoadOpenGL(glfw.GetOpenGLLoader());
 
-    glEnable(GL_DEPTH_TEST);
+    glt::Enable(glt::Capability::depth_test);
 
     ProgModel program;
 
@@ -69,6 +69,9 @@ int main(int argc, const char **argv)
         glClearColor(0.258824f, 0.435294f, 0.258824f, 1);
         glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
 
+		// textures are decoded by the loader, at most 8 MB are uploaded per frame
+		cachedTextures.Upload(8 << 20);
+
 		{
 			view = glm::translate(glm::mat4(1.0f), glm::vec3(0, -10, -20));
 			projection = glm::perspective(glm::radians(45.0f),
@@ -58,6 +58,11 @@ namespace glt
             return buf_.IsMapped();
         }
 
+		const HandleBuffer& BufferHandle() const
+		{
+			return buf_.Handle();
+		}
+
         void UnMap()
         {
             buf_.UnMap();
@@ -118,6 +123,12 @@ namespace glt
 			return layout_.BufferOffset();
 		}
 
+		// handle of the buffer the sequence belongs to
+		const HandleBuffer& BufferHandle() const
+		{
+			return dataInput_.BufferHandle();
+		}
+
 		void SubData(compound_t<Attrs...> *data, size_t sz, size_t inst_offset = 0)
 		{
 			dataInput_.SubData(data, sz, inst_offset);
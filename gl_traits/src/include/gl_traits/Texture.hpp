@@ -17,13 +17,32 @@ namespace glt
             : tex_base(std::move(handle))
         {}
 
+        // another Texture object referencing the same OpenGL texture,
+        // the texture is deleted with the last object referencing it
+        Texture Share() const
+        {
+            return Texture(*this, share_tag());
+        }
+
+        size_t UseCount() const
+        {
+            return texture_base::handle_.UseCount();
+        }
+
         using tex_base::Bind;
         using tex_base::UnBind;
 		using tex_base::GenerateMipMap;
-//        using tex_base::SetStorage;
+        using tex_base::SetStorage;
+        using tex_base::SetMipChain;
 
         using texture_base::Initialized;
 
+    private:
+
+        Texture(const Texture& other, share_tag tag)
+            : tex_base(other, tag)
+        {}
+
     };
 
     template <TexInternFormat internalFormat>
@@ -35,6 +54,16 @@ namespace glt
     template <TexInternFormat internalFormat>    
     using Texture3D = Texture<TextureTarget::texture_3d, internalFormat>;
 
+    // layers are the last dimension of the images
+    template <TexInternFormat internalFormat>
+    using Texture1DArray = Texture<TextureTarget::texture_1d_array, internalFormat>;
+
+    template <TexInternFormat internalFormat>
+    using Texture2DArray = Texture<TextureTarget::texture_2d_array, internalFormat>;
+
+    template <TexInternFormat internalFormat>
+    using TextureCubeMap = Texture<TextureTarget::texture_cube_map, internalFormat>;
+
 	using Texture2Drgba = Texture2D<TexInternFormat::rgba>;
 
 }
\ No newline at end of file
@@ -3,12 +3,9 @@
 /*
 TODO: rename *classname*_base to *classname*_state (?)
 
-Since glGet() is considered to be slow, the solution might be to store the state.
-However, querying state might use 2 implementation, depending on configuration:
-1. Using stored state;
-2. Using glGet;
-
-TODO: add configuration-driven implementation either using a MACRO of if constexpr.
+Since glGet() is considered to be slow, the state is stored in gl_state.
+Whether stored state is cross-checked with glGet is configured with GLT_STATE_POLICY
+(see gl_state.hpp).
 */
 
 #include "equivalence.hpp"
@@ -20,8 +17,12 @@ TODO: add configuration-driven implementation either using a MACRO of if constex
 #include "type_converions.hpp"
 
 #include "gltHandle.hpp"
+#include "gl_state.hpp"
 
 #include <array>
+#include <bitset>
+#include <memory>
+#include <utility>
 
 namespace glt
 {
@@ -88,34 +89,19 @@ namespace glt
 	// TODO: remove Handle object to the buffer class?
 	class buffer_base
 	{
-		// this may be optimized out in release?
-		static std::map<BufferTarget, buffer_base*> targets_;
-
-		// will unregister previous buffer and register new ptr
-		static void Register(BufferTarget target, buffer_base* ptr = nullptr)
-		{
-			buffer_base *&current = targets_[target];
-			if (current)
-				current->target_ = BufferTarget::none;
-
-			current = ptr;
-			if (current)
-				current->target_ = target;
-		}
-
-
 	protected:
 
-		HandleBuffer handle_;
+		// may be shared with other buffer objects (see Share)
+		SharedHandle<BufferTarget> handle_;
 
-		// one buffer can be mapped to multiple targets (?)
+		// last target the buffer has been bound to
 		BufferTarget target_ = BufferTarget::none;
 		BufUsage currentUsage_ = BufUsage::none;
 
 		MapAccess mapAccess_ = MapAccess::none;
 		MapAccessBit mapAccessBit_ = MapAccessBit::none;
 
-		constexpr buffer_base(HandleBuffer&& handle)
+		buffer_base(HandleBuffer&& handle)
 			: handle_(std::move(handle))
 		{
 			assert(handle_ && "Invalid Handle!");
@@ -124,16 +110,20 @@ namespace glt
 		buffer_base(const buffer_base&) = delete;
 		buffer_base& operator=(const buffer_base& other) = delete;
 
-		constexpr buffer_base(buffer_base&& other)
+		// references the same OpenGL buffer, mapping state is not shared
+		buffer_base(const buffer_base& other, share_tag)
+			: handle_(other.handle_),
+			target_(other.target_),
+			currentUsage_(other.currentUsage_)
+		{}
+
+		buffer_base(buffer_base&& other)
 			: handle_(std::move(other.handle_)),
 			target_(other.target_),
 			currentUsage_(other.currentUsage_),
 			mapAccess_(other.mapAccess_),
 			mapAccessBit_(other.mapAccessBit_)
 		{
-			if (other.IsBound())
-				Register(other.Bound(), this);
-
 			other.target_ = BufferTarget::none;
 			other.currentUsage_ = BufUsage::none;
 			other.mapAccess_ = MapAccess::none;
@@ -142,15 +132,14 @@ namespace glt
 
 		buffer_base& operator=(buffer_base&& other)
 		{
+			Release();
+
 			handle_ = std::move(other.handle_);
 			target_ = other.target_;
 			currentUsage_ = other.currentUsage_;
 			mapAccess_ = other.mapAccess_;
 			mapAccessBit_ = other.mapAccessBit_;
 
-			if (other.IsBound())
-				Register(other.Bound(), this);
-
 			other.target_ = BufferTarget::none;
 			other.currentUsage_ = BufUsage::none;
 			other.mapAccess_ = MapAccess::none;
@@ -159,54 +148,69 @@ namespace glt
 			return *this;
 		}
 
-
 		~buffer_base()
 		{
-			// does opengl auto unmap data?
-			if (IsMapped())
-				UnMap();
+			Release();
+		}
 
-			if (IsBound())
-				UnBind();
+	private:
 
+		// handle is about to be deleted, the cache is updated by the Handle
+		void Release()
+		{
+			if (!handle_ || !IsMapped())
+				return;
+
+			// deleting a buffer unmaps it, retired buffers may be released on threads
+			// without OpenGL context and are deleted by the queue
+			if (Context::Retiring())
+				return;
+
+			UnMap();
 		}
+
 	public:
 
-		// Will register current buffer for the given target and unregister previous if any
+		// Will replace a buffer previously bound to the target if any
 		void Bind(BufferTarget target)
 		{
-			glBindBuffer((GLenum)target, handle_accessor(handle_));
+			gl_state::Current().BindBuffer(target, handle_accessor(handle_));
 
             assert(AssertGL());
 
-			Register(target, this);
+			target_ = target;
 		}
 
 		static bool TargetMapped(BufferTarget target)
 		{
-			// TODO: check if target is valid!
-			return (bool)targets_[target];
+			GLuint bound = gl_state::Current().Buffer(target);
+			return bound && bound != gl_state::unknown;
+		}
+
+		BufferTarget Bound() const
+		{
+			return IsBound() ? target_ : BufferTarget::none;
 		}
 
-		constexpr BufferTarget Bound() const
+		bool IsBound() const
 		{
-			return target_;
+			return handle_ && target_ != BufferTarget::none &&
+				gl_state::Current().Buffer(target_) == (GLuint)handle_accessor(handle_);
 		}
 
-		constexpr bool IsBound() const
+		const HandleBuffer& Handle() const
 		{
-			return Bound() != BufferTarget::none;
+			return handle_.Get();
 		}
 
 		void UnBind()
 		{
 			assert(IsBound() && "Buffer is alraedy not bound");
-			if (Bound() == BufferTarget::none)
+			if (!IsBound())
 				throw std::exception("Trying to unbind non-bound buffer!");
 
-			glBindBuffer((GLenum)target_, 0);
+			gl_state::Current().BindBuffer(target_, 0);
 			assert(AssertGL());
-			Register(target_);
 		}
 
 		constexpr MapAccess MapAccess() const
@@ -248,8 +252,18 @@ namespace glt
 
     class vao_base
     {
-        static vao_base* active_vao_;
+    public:
+        // GL_MAX_VERTEX_ATTRIBS guaranteed minimum
+        constexpr static size_t max_vertex_attribs = 16;
 
+    private:
+        // vertex attribute arrays enabled for this VAO
+        std::bitset<max_vertex_attribs> enabled_;
+
+        // element array buffer set by VAO::BindElementBuffer and its count of indices,
+        // the binding itself is tracked by gl_state
+        GLuint elementBuffer_ = 0;
+        size_t elementCount_ = 0;
 
 
     protected:
@@ -273,59 +287,104 @@ namespace glt
         vao_base& operator=(const vao_base&) = delete;
 
         vao_base(vao_base&& other)
-            : handle_(std::move(other.handle_))
-        {
-            if (other.IsBound())
-                Register(this);
-        }
+            : enabled_(other.enabled_),
+            elementBuffer_(other.elementBuffer_),
+            elementCount_(other.elementCount_),
+            handle_(std::move(other.handle_))
+        {}
 
         vao_base& operator=(vao_base&& other)
         {
             handle_ = std::move(other.handle_);
-
-            if (other.IsBound())
-                Register(this);
+            enabled_ = other.enabled_;
+            elementBuffer_ = other.elementBuffer_;
+            elementCount_ = other.elementCount_;
 
             return *this;
         }
 
+        // binds the buffer to the element array target of the bound VAO
+        void SetElementBuffer(GLuint buffer, size_t count)
+        {
+            assert(IsBound() && "Binding element buffer to non-active VAO!");
+
+            gl_state::Current().BindBuffer(BufferTarget::element_array, buffer);
+            elementBuffer_ = buffer;
+            elementCount_ = buffer ? count : 0;
+        }
+
     public:
         void Bind()
         {
-            glBindVertexArray(handle_accessor(handle_));
+            gl_state::Current().BindVertexArray(handle_accessor(handle_));
             assert(AssertGL());
-
-            Register(this);
         }
 
         bool IsBound() const
         {
-            return this == active_vao_;
+            return handle_ &&
+                gl_state::Current().VertexArray() == (GLuint)handle_accessor(handle_);
+        }
+
+        // 0 - none, gl_state::unknown - bound bypassing the cache or deleted
+        GLuint ElementBuffer() const
+        {
+            return gl_state::Current().ElementBuffer(handle_accessor(handle_));
+        }
+
+        // indices of the buffer set by VAO::BindElementBuffer when it has been set,
+        // 0 if the element buffer has been replaced since then
+        size_t ElementCount() const
+        {
+            GLuint bound = ElementBuffer();
+            return bound && bound == elementBuffer_ ? elementCount_ : 0;
         }
 
         void UnBind()
         {
             assert(IsBound() && "Unbinding non-bound VAO!");
-            glBindVertexArray(0);
+            gl_state::Current().BindVertexArray(0);
             assert(AssertGL());
+        }
+
+        // redundant calls for already enabled/disabled arrays are skipped
+        void EnableArray(GLuint indx)
+        {
+            assert(IsBound() && "Enabling attribute array of non-active VAO!");
+            assert(indx < max_vertex_attribs && "Invalid attribute index!");
+
+            if (enabled_[indx])
+                return;
 
-            Register();
+            glEnableVertexAttribArray(indx);
+            enabled_.set(indx);
         }
 
-	private:
+        void DisableArray(GLuint indx)
+        {
+            assert(IsBound() && "Disabling attribute array of non-active VAO!");
+            assert(indx < max_vertex_attribs && "Invalid attribute index!");
 
-		static void Register(vao_base* vao = nullptr)
-		{
-			active_vao_ = vao;
-		}
+            if (!enabled_[indx])
+                return;
 
+            glDisableVertexAttribArray(indx);
+            enabled_.reset(indx);
+        }
+
+        bool ArrayEnabled(GLuint indx) const
+        {
+            return enabled_[indx];
+        }
+
+        const HandleVAO& Handle() const
+        {
+            return handle_;
+        }
     };
 
 	class program_base
 	{
-
-		static program_base *active_prog_;
-
 		HandleProg handle_;
 		bool linked_ = false;
 
@@ -344,9 +403,6 @@ namespace glt
 			: handle_(std::move(other.handle_)),
 			linked_(other.linked_)
 		{
-			if (other.IsActive())
-				Register(this);
-
 			other.linked_ = false;
 		}
 
@@ -355,9 +411,6 @@ namespace glt
 			handle_ = std::move(other.handle_);
 			linked_ = other.linked_;
 
-			if (other.IsActive())
-				Register(this);
-
 			other.linked_ = false;
 
 			return *this;
@@ -373,32 +426,24 @@ namespace glt
 			linked_ = linked;
 		}
 
-	private:
-
-		static void Register(program_base *prog = nullptr)
-		{
-			active_prog_ = prog;
-		}
-
 	public:
 
         void Use()
         {
             assert(*this && "Attemplt to use invalid program!");
-            glUseProgram(handle_accessor(handle_));
-            Register(this);
+            gl_state::Current().UseProgram(handle_accessor(handle_));
         }
 
         void UnUse()
         {
             assert(IsActive() && "Attempt to unuse non-active program!");
-            glUseProgram(0);
-            Register();
+            gl_state::Current().UseProgram(0);
         }
 
 		bool IsActive() const
 		{
-			return this == active_prog_;
+			return handle_ &&
+				gl_state::Current().Program() == (GLuint)handle_accessor(handle_);
 		}
 
 		bool Linked() const
@@ -419,15 +464,24 @@ namespace glt
         const program_base& prog_;
 		GLint location_ = -1;
 
+        // explicit location from the shader source (glt_location), -1 if not specified
+        const GLint explicitLocation_ = -1;
+
+        // shadow value of the uniform is known (see Uniform::Set)
+        mutable bool shadowed_ = false;
+
 		// by default
-		uniform_base(const program_base& prog, const char* name)
+		uniform_base(const program_base& prog, const char* name, GLint explicitLocation = -1)
 			: prog_(prog),
-            location_(prog.Linked() ? GetLocation_(prog, name) : -1)
+            location_(prog.Linked() ? GetLocation_(prog, name, explicitLocation) : -1),
+            explicitLocation_(explicitLocation)
 		{}
 
+        // linking resets values of the uniforms
         void GetLocation(const char* name)
         {
-            location_ = GetLocation_(prog_, name);
+            location_ = GetLocation_(prog_, name, explicitLocation_);
+            shadowed_ = false;
         }
 
         bool IsValid() const
@@ -437,10 +491,13 @@ namespace glt
 
     private:
 
-		static GLint GetLocation_(const program_base& prog, const char* name)
+		static GLint GetLocation_(const program_base& prog, const char* name, GLint explicitLocation)
 		{
 			assert(prog.Linked() &&
 				"Attempt to get Uniform location of a non-linked program");
+            if (explicitLocation >= 0)
+                return explicitLocation;
+
 			GLint ret = glGetUniformLocation(handle_accessor(prog.Handle()), name);
 			assert(ret != -1 && "Failed to get Unifrom location");
 			return ret;
@@ -450,37 +507,26 @@ namespace glt
 
     class texture_base
     {
-        static std::array<texture_base*, TextureTargetList::size>
-            active_textures_;
-
-        template <class TexTarList>
-        struct get_tar_indx;
+    protected:
+        // may be shared with other texture objects (see Share)
+        SharedHandle<TextureTarget> handle_;
+        TextureTarget target_ = TextureTarget::none; // until bound first time
 
-        template <TextureTarget ... tar>
-        struct get_tar_indx<values_list<TextureTarget, tar...>>
+        struct texture_info
         {
-            constexpr static std::array<TextureTarget, sizeof...(tar)> targets{ tar... };
-
-            template <TextureTarget find>
-            constexpr static size_t get_index()
-            {
-                for (size_t indx = 0; indx != targets.size(); ++indx)
-                    if (find == targets[indx])
-                        return indx;
-            }
+            unsigned int lod = 0,
+                width = 0,
+                height = 0,
+                depth = 0;
+
+            // mip levels allocated, immutable storage (glTexStorage*) can not be respecified
+            unsigned int levels = 0;
+            bool immutable = false;
         };
 
-       
-    protected:
-        HandleTexture handle_;
-        bool bound_ = false;
-        TextureTarget target_ = TextureTarget::none; // until bound first time
-
-        // TODO: store texture attributes? (levels, width, height, depth, etc)
-        unsigned int lod_ = 0,
-            width_ = 0,
-            height_ = 0,
-            depth_ = 0;
+        // shared with the texture objects sharing the handle, thus an image specified
+        // through one of them (i.e. asynchronous loading) updates the sizes of all
+        std::shared_ptr<texture_info> info_;
 
 	public:
 
@@ -500,15 +546,21 @@ namespace glt
 
 			void SetLOD(unsigned int lod)
 			{
-				state_.lod_ = lod;
+				state_.info_->lod = lod;
 			}
 
 			void SetSizes(unsigned int width, unsigned int height = 0,
 				unsigned int depth = 0)
 			{
-				state_.width_ = width;
-				state_.height_ = height;
-				state_.depth_ = depth;
+				state_.info_->width = width;
+				state_.info_->height = height;
+				state_.info_->depth = depth;
+			}
+
+			void SetLevels(unsigned int levels, bool immutable = false)
+			{
+				state_.info_->levels = levels;
+				state_.info_->immutable = immutable;
 			}
 
 		};
@@ -520,59 +572,59 @@ namespace glt
 			return modifier(*this);
 		}
 
-        template <TextureTarget target>
-        static void Register(texture_base *ptr = nullptr)
-        {
-            constexpr size_t indx = get_tar_indx<TextureTargetList>::get_index<target>();
-
-            static_assert(indx < TextureTargetList::size, "Invalid texture target!");
-
-
-            if (active_textures_[indx])
-                active_textures_[indx]->bound_ = false;
-
-            active_textures_[indx] = ptr;
-            if (ptr)
-                ptr->bound_ = true;
-        }
-     
         texture_base(HandleTexture&& handle_, TextureTarget target)
             : handle_(std::move(handle_)),
-            target_(target)
+            target_(target),
+            info_(std::make_shared<texture_info>())
         {}
 
         texture_base(const texture_base&) = delete;
         texture_base& operator=(const texture_base&) = delete;
 
+        // references the same OpenGL texture
+        texture_base(const texture_base& other, share_tag)
+            : handle_(other.handle_),
+            target_(other.target_),
+            info_(other.info_)
+        {}
+
         texture_base(texture_base&& other)
             : handle_(std::move(other.handle_)),
-            bound_(other.bound_),
-            target_(other.target_)
+            target_(other.target_),
+            info_(std::move(other.info_))
         {
-            other.bound_ = false;
             other.target_ = TextureTarget::none;
         }
 
         texture_base& operator=(texture_base&& other)
         {
             handle_ = std::move(other.handle_);
-            bound_ = other.bound_;
             target_ = other.target_;
+            info_ = std::move(other.info_);
 
-            other.bound_ = false;
             other.target_ = TextureTarget::none;
+
+            return *this;
         }
 
     public:
 
+        // bound to the active texture unit
         bool IsBound() const
         {
-            return bound_;
+            return handle_ && Initialized() &&
+                gl_state::Current().Texture(target_) == (GLuint)handle_accessor(handle_);
+        }
+
+        bool IsBound(GLuint unit) const
+        {
+            return handle_ && Initialized() &&
+                gl_state::Current().Texture(unit, target_) == (GLuint)handle_accessor(handle_);
         }
 
         const HandleTexture& Handle() const
         {
-            return handle_;
+            return handle_.Get();
         }
         
         TextureTarget Target() const
@@ -590,6 +642,38 @@ namespace glt
             return handle_;
         }
 
+        // level the sizes have been specified for last
+        unsigned int LOD() const
+        {
+            return info_->lod;
+        }
+
+        // 0 - dimension of the target is missing
+        unsigned int Width() const
+        {
+            return info_->width;
+        }
+
+        unsigned int Height() const
+        {
+            return info_->height;
+        }
+
+        unsigned int Depth() const
+        {
+            return info_->depth;
+        }
+
+        unsigned int Levels() const
+        {
+            return info_->levels;
+        }
+
+        bool Immutable() const
+        {
+            return info_->immutable;
+        }
+
 		// TODO: add check if texture has been set (with sizes)
 		
 
@@ -598,11 +682,9 @@ namespace glt
 
 	class framebuffer_base
 	{
-
-		static std::map<FrameBufTarget, framebuffer_base*> bound_;
-
 	protected:
 		HandleFrameBuffer handle_;
+		// last target the framebuffer has been bound to
 		FrameBufTarget target_ = FrameBufTarget::none;
 
 		framebuffer_base(HandleFrameBuffer&& handle)
@@ -614,69 +696,46 @@ namespace glt
 
 		framebuffer_base(framebuffer_base&& other)
 			: handle_(std::move(other.handle_)),
-			target_(FrameBufTarget::none)
+			target_(other.target_)
 		{
-			if (other.IsBound())
-				Register(other.Target(), this);
+			other.target_ = FrameBufTarget::none;
 		}
 
 		framebuffer_base& operator=(framebuffer_base&& other)
 		{
-			// does opengl implicitly unbind buffer on deleting?
-			if (IsBound())
-				UnBind();
-
 			handle_ = std::move(other.handle_);
-			if (other.IsBound())
-				Register(other.Target(), this);
+			target_ = other.target_;
+			other.target_ = FrameBufTarget::none;
 
 			return *this;
 		}
 
 		void Bind(FrameBufTarget target)
 		{
-			glBindFramebuffer((GLenum)target, handle_accessor(handle_));
-			Register(target, this);
+			gl_state::Current().BindFramebuffer(target, handle_accessor(handle_));
+			target_ = target;
 		}
 
 		FrameBufTarget Target() const
 		{
-			return target_;
+			return IsBound() ? target_ : FrameBufTarget::none;
 		}
 
 		bool IsBound() const
 		{
-			return Target() != FrameBufTarget::none;
+			return handle_ && target_ != FrameBufTarget::none &&
+				gl_state::Current().Framebuffer(target_) == (GLuint)handle_accessor(handle_);
 		}
 
 		void UnBind()
 		{
 			assert(IsBound() && "Attempt to unbind non-active FrameBuffer!");
-			glBindFramebuffer((GLenum)target_, 0);
-			Register(target_);
-		}
-
-	private:
-
-		void Register(FrameBufTarget target, framebuffer_base *fbuf = nullptr)
-		{
-			framebuffer_base *&bound = bound_[target];
-
-			if (bound)
-				bound->target_ = FrameBufTarget::none;
-
-			bound = fbuf;
-
-			if (fbuf)
-				fbuf->target_ = target;
+			gl_state::Current().BindFramebuffer(target_, 0);
 		}
 	};
 
 	class renderbuffer_base
 	{
-
-		static renderbuffer_base *bound_;
-
 	protected:
 		HandleRenderBuffer handle_;
 
@@ -686,29 +745,19 @@ namespace glt
 
 		void Bind()
 		{
-			glBindRenderbuffer((GLenum)RenderBufferTarget::renderbuffer,
-				handle_accessor(handle_));
-
-			Register(this);
+			gl_state::Current().BindRenderbuffer(handle_accessor(handle_));
 		}
 
 		bool IsBound() const
 		{
-			return this == bound_;
+			return handle_ &&
+				gl_state::Current().Renderbuffer() == (GLuint)handle_accessor(handle_);
 		}
 
 		void UnBind()
 		{
 			assert(IsBound() && "Attempt to unbind non-active renderbuffer!");
-			glBindRenderbuffer((GLenum)RenderBufferTarget::renderbuffer, 0);
-			Register();
-		}
-
-	private:
-
-		void Register(renderbuffer_base *rbuffer = nullptr)
-		{
-			bound_ = rbuffer;
+			gl_state::Current().BindRenderbuffer(0);
 		}
 
 	};
@@ -176,6 +176,18 @@ namespace glt
 		}        
         // TODO: add allocating constructor
 
+        // another Buffer object referencing the same OpenGL buffer and layout,
+        // the buffer is deleted with the last object referencing it
+        Buffer Share() const
+        {
+            return Buffer(*this, share_tag());
+        }
+
+        size_t UseCount() const
+        {
+            return handle_.UseCount();
+        }
+
         void Bind(BufferTarget target)
         {
             using A = std::tuple_element_t<0, std::tuple<attribs...>>;
@@ -231,6 +243,15 @@ namespace glt
         // - AttribPointer function from the first sequence 
         // - user-defined conversion to the first sequence
         // - user-defined conversion to the first attribute of the first sequence
+
+    private:
+
+        Buffer(const Buffer& other, share_tag tag)
+            : buffer_base(other, tag),
+            aggr_sequences(static_cast<buffer_base&>(*this))
+        {
+            aggr_sequences::offsets_ = other.offsets_;
+        }
 	};
 
 	template <class Buf1, class Buf2>
@@ -0,0 +1,260 @@
+#pragma once
+
+/*
+List of rendering commands recorded without OpenGL and replayed on the context thread.
+
+Commands are stored as a compact binary stream in a single growing buffer, thus
+recording does not allocate once the list has reached its working size (see Reset).
+Lists are not synchronized: each thread records into its own lists, which are then
+replayed by the thread the context is current on in the required order:
+
+    // worker threads
+    list.UseProgram(program);
+    list.BindVertexArray(vao);
+    list.SetUniform(program.Uniform(tag_t<model_mat4>()), model);
+    list.DrawElements(RenderMode::triangles, count);
+
+    // context thread
+    for (CommandList& list : lists)
+        list.Replay();
+
+Bindings are replayed through gl_state, redundant ones are skipped.
+Uniforms are set through the Uniform objects, thus their shadow values stay valid. The
+objects must outlive the recorded commands.
+*/
+
+#include "uniform_traits.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace glt
+{
+    class CommandList
+    {
+        enum class command : std::uint8_t
+        {
+            use_program,
+            bind_vertex_array,
+            bind_texture,
+            bind_buffer_range,
+            set_uniform,
+            draw_arrays,
+            draw_elements
+        };
+
+        struct header
+        {
+            command cmd;
+            std::uint32_t size; // of the payload
+        };
+
+        struct bind_texture
+        {
+            GLuint unit;
+            TextureTarget target;
+            GLuint texture;
+        };
+
+        struct bind_buffer_range
+        {
+            BufferTarget target;
+            GLuint index,
+                buffer;
+            GLintptr offset;
+            GLsizeiptr size;
+        };
+
+        using uniform_setter = void(*)(void*, const unsigned char*);
+
+        struct set_uniform
+        {
+            void *uniform;
+            uniform_setter setter;
+            // value follows
+        };
+
+        struct draw
+        {
+            RenderMode mode;
+            GLint first; // vertex or index
+            GLsizei count;
+        };
+
+        std::vector<unsigned char> stream_;
+        size_t commands_ = 0;
+
+    public:
+
+        CommandList() = default;
+
+        CommandList(size_t reserveBytes)
+        {
+            stream_.reserve(reserveBytes);
+        }
+
+        void UseProgram(GLuint program)
+        {
+            Append(command::use_program, program);
+        }
+
+        void BindVertexArray(GLuint vao)
+        {
+            Append(command::bind_vertex_array, vao);
+        }
+
+        void BindTexture(GLuint unit, TextureTarget target, GLuint texture)
+        {
+            Append(command::bind_texture, bind_texture{ unit, target, texture });
+        }
+
+        void BindBufferRange(BufferTarget target, GLuint index, GLuint buffer,
+            GLintptr offset = 0, GLsizeiptr size = 0)
+        {
+            Append(command::bind_buffer_range, bind_buffer_range{ target, index, buffer, offset, size });
+        }
+
+        // uniform - Uniform of a program (see uniform_collection::Uniform)
+        template <class T, class I>
+        void SetUniform(Uniform<T, I>& uniform, const typename Uniform<T, I>::ret_type& value)
+        {
+            using value_type = typename Uniform<T, I>::ret_type;
+            static_assert(std::is_trivially_copyable_v<value_type>, "Unsupported uniform type!");
+
+            set_uniform cmd{ &uniform, &SetUniform_<Uniform<T, I>> };
+
+            WriteHeader(command::set_uniform, sizeof(cmd) + sizeof(value_type));
+            Write(cmd);
+            Write(value);
+        }
+
+        void DrawArrays(RenderMode mode, GLint first, GLsizei count)
+        {
+            Append(command::draw_arrays, draw{ mode, first, count });
+        }
+
+        // GL_UNSIGNED_INT indices of the element buffer of the bound VAO
+        void DrawElements(RenderMode mode, GLsizei count, GLint first = 0)
+        {
+            Append(command::draw_elements, draw{ mode, first, count });
+        }
+
+        // must be called on the thread the context is current on
+        void Replay(gl_state& state = gl_state::Current()) const
+        {
+            const unsigned char *pos = stream_.data(),
+                *end = pos + stream_.size();
+
+            while (pos != end)
+            {
+                header h = Read<header>(pos);
+                const unsigned char *payload = pos;
+                pos += h.size;
+
+                switch (h.cmd)
+                {
+                case command::use_program:
+                    state.UseProgram(Read<GLuint>(payload));
+                    break;
+                case command::bind_vertex_array:
+                    state.BindVertexArray(Read<GLuint>(payload));
+                    break;
+                case command::bind_texture:
+                {
+                    bind_texture cmd = Read<bind_texture>(payload);
+                    state.BindTexture(cmd.unit, cmd.target, cmd.texture);
+                    break;
+                }
+                case command::bind_buffer_range:
+                {
+                    bind_buffer_range cmd = Read<bind_buffer_range>(payload);
+                    state.BindBufferRange(cmd.target, cmd.index, cmd.buffer, cmd.offset, cmd.size);
+                    break;
+                }
+                case command::set_uniform:
+                {
+                    set_uniform cmd = Read<set_uniform>(payload);
+                    (*cmd.setter)(cmd.uniform, payload);
+                    break;
+                }
+                case command::draw_arrays:
+                {
+                    draw cmd = Read<draw>(payload);
+                    glDrawArrays((GLenum)cmd.mode, cmd.first, cmd.count);
+                    break;
+                }
+                case command::draw_elements:
+                {
+                    draw cmd = Read<draw>(payload);
+                    glDrawElements((GLenum)cmd.mode, cmd.count, GL_UNSIGNED_INT,
+                        (const void*)(cmd.first * sizeof(GLuint)));
+                    break;
+                }
+                default:
+                    assert(false && "Unhandled command!");
+                    break;
+                }
+            }
+        }
+
+        // keeps the memory for the next recording
+        void Reset()
+        {
+            stream_.clear();
+            commands_ = 0;
+        }
+
+        size_t Commands() const
+        {
+            return commands_;
+        }
+
+        size_t Bytes() const
+        {
+            return stream_.size();
+        }
+
+    private:
+
+        template <class T>
+        void Append(command cmd, const T& payload)
+        {
+            WriteHeader(cmd, sizeof(T));
+            Write(payload);
+        }
+
+        void WriteHeader(command cmd, size_t size)
+        {
+            Write(header{ cmd, (std::uint32_t)size });
+            ++commands_;
+        }
+
+        template <class T>
+        void Write(const T& val)
+        {
+            size_t size = stream_.size();
+            stream_.resize(size + sizeof(T));
+            std::memcpy(stream_.data() + size, &val, sizeof(T));
+        }
+
+        // the stream is not aligned
+        template <class T>
+        static T Read(const unsigned char *&pos)
+        {
+            T val;
+            std::memcpy(&val, pos, sizeof(T));
+            pos += sizeof(T);
+            return val;
+        }
+
+        // redundant values are skipped by the Uniform
+        template <class unif_t>
+        static void SetUniform_(void *uniform, const unsigned char *data)
+        {
+            static_cast<unif_t*>(uniform)->Set(Read<typename unif_t::ret_type>(data));
+        }
+    };
+
+}
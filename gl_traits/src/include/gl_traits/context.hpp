@@ -0,0 +1,201 @@
+#pragma once
+
+/*
+glt::Context holds the state that belongs to a single OpenGL context.
+
+OpenGL contexts are created by the windowing library (GLFW, etc). Context must be
+made current on the thread together with the OpenGL context it represents:
+
+    glfwMakeContextCurrent(window);
+    context.MakeCurrent();
+
+The current Context is stored per thread. Threads that have not made any Context
+current use the default Context, thus single-context applications do not need
+to create one.
+
+Context may own handle pools (see handle_pool.hpp). Objects of a pooled type are
+allocated from the pool of the Context current at construction and released to the
+pool of the Context current at destruction. Pools must be disabled (or the Context
+destroyed) while the OpenGL context is still current.
+
+Context may defer deletion of objects (see retire_queue.hpp). Handles destroyed on
+a thread with the Context current, or on a thread without a current Context if the
+Context has been set as the target for such threads, are retired to its queue.
+EndFrame must then be called once per frame by the thread the Context is current on.
+*/
+
+#include "gl_state.hpp"
+#include "handle_pool.hpp"
+#include "retire_queue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <tuple>
+
+namespace glt
+{
+    using PoolableTypes = std::tuple<BufferTarget,
+        TextureTarget,
+        VAOTarget,
+        FrameBufTarget,
+        RenderBufferTarget,
+        SamplerTarget,
+        QueryTarget,
+        TransformFeedBackTarget,
+        ProgramPipeLineTarget>;
+
+    template <class Tuple>
+    struct handle_pools;
+
+    template <typename ... eTargetTypes>
+    struct handle_pools<std::tuple<eTargetTypes...>>
+    {
+        using type = std::tuple<std::unique_ptr<HandlePool<eTargetTypes>>...>;
+    };
+
+    class Context
+    {
+        gl_state state_;
+
+        typename handle_pools<PoolableTypes>::type pools_;
+
+        std::unique_ptr<RetireQueue> retire_;
+
+        static thread_local Context *current_;
+
+        // target of the handles destroyed on threads without a current Context
+        static std::atomic<Context*> retireTarget_;
+
+    public:
+
+        Context() = default;
+
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+
+        // OpenGL context must be current if pools or deferred deletion are enabled
+        ~Context()
+        {
+            DisableDeferredDeletion();
+
+            if (current_ == this)
+                current_ = nullptr;
+        }
+
+        // makes Context current for the calling thread
+        void MakeCurrent()
+        {
+            current_ = this;
+        }
+
+        bool IsCurrent() const
+        {
+            return &Current() == this;
+        }
+
+        // resets the calling thread to the default Context
+        static void ReleaseCurrent()
+        {
+            current_ = nullptr;
+        }
+
+        gl_state& State()
+        {
+            return state_;
+        }
+
+        const gl_state& State() const
+        {
+            return state_;
+        }
+
+        template <typename eTargetType>
+        void EnablePool(size_t blockSize = 64, size_t deleteBatch = 64)
+        {
+            auto& pool = std::get<std::unique_ptr<HandlePool<eTargetType>>>(pools_);
+            assert(!pool && "Pool is already enabled!");
+
+            pool = std::make_unique<HandlePool<eTargetType>>(blockSize, deleteBatch);
+        }
+
+        // deletes released and unused objects of the pool
+        template <typename eTargetType>
+        void DisablePool()
+        {
+            std::get<std::unique_ptr<HandlePool<eTargetType>>>(pools_).reset();
+        }
+
+        // nullptr if pooling is not enabled for the type
+        template <typename eTargetType>
+        HandlePool<eTargetType>* Pool()
+        {
+            if constexpr (is_poolable_v<eTargetType>)
+                return std::get<std::unique_ptr<HandlePool<eTargetType>>>(pools_).get();
+            else
+                return nullptr;
+        }
+
+        // deletes released objects of all the pools
+        void FlushPools()
+        {
+            std::apply([](auto& ... pools)
+            {
+                ((pools ? pools->Flush() : void()), ...);
+            }, pools_);
+        }
+
+        // anyThread - retire handles destroyed on threads without a current Context
+        void EnableDeferredDeletion(bool anyThread = true)
+        {
+            assert(!retire_ && "Deferred deletion is already enabled!");
+            retire_ = std::make_unique<RetireQueue>();
+
+            if (anyThread)
+                retireTarget_ = this;
+        }
+
+        // deletes all the retired objects, waits for the GPU if necessary
+        void DisableDeferredDeletion()
+        {
+            if (!retire_)
+                return;
+
+            Context *self = this;
+            retireTarget_.compare_exchange_strong(self, nullptr);
+
+            retire_->Flush(state_);
+            retire_.reset();
+        }
+
+        RetireQueue* Retire()
+        {
+            return retire_.get();
+        }
+
+        // fences the objects retired during the frame, deletes objects of
+        // previous frames which fences have signalled
+        void EndFrame()
+        {
+            if (retire_)
+                retire_->EndFrame(state_);
+        }
+
+        // queue for the handles destroyed on the calling thread, nullptr - delete immediately
+        static RetireQueue* Retiring()
+        {
+            if (current_)
+                return current_->Retire();
+
+            Context *target = retireTarget_;
+            return target ? target->Retire() : Default().Retire();
+        }
+
+        static Context& Current()
+        {
+            return current_ ? *current_ : Default();
+        }
+
+        static Context& Default();
+    };
+
+}
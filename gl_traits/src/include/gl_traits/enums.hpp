@@ -3,6 +3,14 @@
 // TODO: remove it, use own generator to generate enums directly from specs
 #include "glad/glad.h"
 
+// EXT_texture_compression_s3tc is not a part of the core profile
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace glt
 {
     template <typename T, T ... vals>
@@ -65,6 +73,13 @@ namespace glt
 		BufferTarget::transform_feedback,
 		BufferTarget::uniform>;
 
+	// targets with indexed binding points (glBindBufferBase/glBindBufferRange)
+	using IndexedBufferTargetList = std::integer_sequence<BufferTarget,
+		BufferTarget::atomic_counter,
+		BufferTarget::shader_storage,
+		BufferTarget::transform_feedback,
+		BufferTarget::uniform>;
+
 
 	enum class glBufferBinding : GLenum
 	{
@@ -224,7 +239,23 @@ namespace glt
         rg16f = GL_RG16F,
         rgb16f = GL_RGB16F,
         rgba16f = GL_RGBA16F,
-        r32f = GL_R32F
+        r32f = GL_R32F,
+
+        // block compressed formats, 4x4 texel blocks
+        compressed_rgb_s3tc_dxt1 = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,     // BC1
+        compressed_rgba_s3tc_dxt1 = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,   // BC1
+        compressed_rgba_s3tc_dxt3 = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,   // BC2
+        compressed_rgba_s3tc_dxt5 = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,   // BC3
+        compressed_red_rgtc1 = GL_COMPRESSED_RED_RGTC1,                 // BC4
+        compressed_signed_red_rgtc1 = GL_COMPRESSED_SIGNED_RED_RGTC1,
+        compressed_rg_rgtc2 = GL_COMPRESSED_RG_RGTC2,                   // BC5
+        compressed_signed_rg_rgtc2 = GL_COMPRESSED_SIGNED_RG_RGTC2,
+        compressed_rgba_bptc_unorm = GL_COMPRESSED_RGBA_BPTC_UNORM,     // BC7
+        compressed_srgb_alpha_bptc_unorm = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
+        compressed_rgb8_etc2 = GL_COMPRESSED_RGB8_ETC2,
+        compressed_srgb8_etc2 = GL_COMPRESSED_SRGB8_ETC2,
+        compressed_rgba8_etc2_eac = GL_COMPRESSED_RGBA8_ETC2_EAC,
+        compressed_srgb8_alpha8_etc2_eac = GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
 
         // TODO: complete?
 
@@ -304,6 +335,34 @@ namespace glt
 		program_point_size = GL_PROGRAM_POINT_SIZE
 	};
 
+	using CapabilityList = values_list<Capability,
+		Capability::blend,
+		Capability::clip_distance0,
+		Capability::color_logic_op,
+		Capability::cull_face,
+		Capability::debug_output,
+		Capability::debug_output_synchronous,
+		Capability::depth_clamp,
+		Capability::depth_test,
+		Capability::dither,
+		Capability::framebuffer_srgb,
+		Capability::line_smooth,
+		Capability::multisample,
+		Capability::polygon_offset_line,
+		Capability::polygon_smooth,
+		Capability::primitive_restart,
+		Capability::primitive_restart_fixed_index,
+		Capability::rasterizer_discard,
+		Capability::sample_alpha_to_coverage,
+		Capability::sample_alpha_to_one,
+		Capability::sample_coverage,
+		Capability::sample_shading,
+		Capability::sample_mask,
+		Capability::scissor_test,
+		Capability::stencil_test,
+		Capability::texture_cube_map_seamless,
+		Capability::program_point_size>;
+
 	enum class MapAccess : int
 	{
         none = 0,
@@ -364,5 +423,38 @@ namespace glt
 		framebuffer = GL_FRAMEBUFFER
 	};
 
+	// sampling parameters
+	enum class TexFilter : GLint
+	{
+		nearest = GL_NEAREST,
+		linear = GL_LINEAR,
+
+		// minification only
+		nearest_mipmap_nearest = GL_NEAREST_MIPMAP_NEAREST,
+		linear_mipmap_nearest = GL_LINEAR_MIPMAP_NEAREST,
+		nearest_mipmap_linear = GL_NEAREST_MIPMAP_LINEAR,
+		linear_mipmap_linear = GL_LINEAR_MIPMAP_LINEAR
+	};
+
+	enum class TexWrap : GLint
+	{
+		repeat = GL_REPEAT,
+		mirrored_repeat = GL_MIRRORED_REPEAT,
+		clamp_to_edge = GL_CLAMP_TO_EDGE,
+		clamp_to_border = GL_CLAMP_TO_BORDER
+	};
+
+	enum class CompareFunc : GLint
+	{
+		never = GL_NEVER,
+		less = GL_LESS,
+		equal = GL_EQUAL,
+		lequal = GL_LEQUAL,
+		greater = GL_GREATER,
+		notequal = GL_NOTEQUAL,
+		gequal = GL_GEQUAL,
+		always = GL_ALWAYS
+	};
+
 
 }
\ No newline at end of file
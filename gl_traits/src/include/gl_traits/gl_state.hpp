@@ -0,0 +1,749 @@
+#pragma once
+
+/*
+Cache of OpenGL binding state for a context.
+
+Binding state is stored as raw handles in flat arrays, indexed by compile-time
+indices of targets within the target lists (BufferTargetList, TextureTargetList, etc).
+Objects query the cache by comparing their handles to the stored ones, thus moving
+an object does not require to update the cache.
+
+Bind/Use calls that match the cached state are not forwarded to OpenGL and are
+counted as elided.
+
+OpenGL state changed bypassing the cache (raw gl calls) makes the cache invalid.
+
+State queries are configured with GLT_STATE_POLICY:
+- GLT_STATE_CACHED: queries return cached state only, no glGet calls (default for NDEBUG);
+- GLT_STATE_VERIFY: cached state is cross-checked with glGet, mismatches are
+logged to std::cerr and counted (default otherwise).
+The policy must be the same in every translation unit of a program, it is defined for
+the gl_traits target and its users by the CMake option GLT_STATE_POLICY.
+*/
+
+#include "enums.hpp"
+
+#include <array>
+#include <bitset>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+#define GLT_STATE_CACHED 0
+#define GLT_STATE_VERIFY 1
+
+#ifndef GLT_STATE_POLICY
+#ifdef NDEBUG
+#define GLT_STATE_POLICY GLT_STATE_CACHED
+#else
+#define GLT_STATE_POLICY GLT_STATE_VERIFY
+#endif
+#endif
+
+namespace glt
+{
+    // index of a value within a list of values (values_list or std::integer_sequence)
+    template <class List>
+    struct list_index;
+
+    template <typename T, T ... vals>
+    struct list_index<values_list<T, vals...>>
+    {
+        constexpr static size_t size = sizeof...(vals);
+
+        // returns size if value is not found
+        constexpr static size_t get(T val)
+        {
+            constexpr T list[]{ vals... };
+            for (size_t i = 0; i != size; ++i)
+                if (list[i] == val)
+                    return i;
+            return size;
+        }
+    };
+
+    template <typename T, T ... vals>
+    struct list_index<std::integer_sequence<T, vals...>> :
+        list_index<values_list<T, vals...>> {};
+
+    template <class List, auto val>
+    constexpr inline size_t list_index_v =
+        std::integral_constant<size_t, list_index<List>::get(val)>::value;
+
+    // groups of cached state for the counters
+    enum class StateGroup : size_t
+    {
+        buffer,
+        buffer_indexed,
+        vao,
+        program,
+        program_pipeline,
+        active_texture,
+        texture,
+        sampler,
+        framebuffer,
+        renderbuffer,
+        capability,
+
+        count
+    };
+
+    enum class StatePolicy
+    {
+        cached = GLT_STATE_CACHED,
+        verify = GLT_STATE_VERIFY
+    };
+
+    constexpr inline StatePolicy state_policy = (StatePolicy)GLT_STATE_POLICY;
+
+    // count of mismatches found by the verify policy
+    inline size_t& state_mismatches()
+    {
+        static thread_local size_t mismatches = 0;
+        return mismatches;
+    }
+
+    // returns cached value, with the verify policy compares it to the value from glGet
+    inline GLuint verify_binding(GLuint cached, GLenum binding, const char *name)
+    {
+        if constexpr (state_policy == StatePolicy::verify)
+        {
+            // binding can not be queried or is not known
+            if (!binding || cached == std::numeric_limits<GLuint>::max())
+                return cached;
+
+            GLint actual = 0;
+            glGetIntegerv(binding, &actual);
+            if ((GLuint)actual != cached)
+            {
+                ++state_mismatches();
+                std::cerr << "glt state mismatch: " << name << " cached " << cached <<
+                    ", actual " << actual << std::endl;
+            }
+        }
+
+        return cached;
+    }
+
+    struct state_counter
+    {
+        size_t issued = 0,
+            elided = 0;
+    };
+
+    class gl_state
+    {
+    public:
+
+        // guaranteed minimums are lower, these are the limits of the cache
+        constexpr static size_t max_texture_units = 32;
+        constexpr static size_t max_indexed_bindings = 32;
+
+        // binding that is not known to the cache (i.e. element array after switching VAO)
+        constexpr static GLuint unknown = std::numeric_limits<GLuint>::max();
+
+        struct indexed_binding
+        {
+            GLuint buffer = 0;
+            GLintptr offset = 0;
+            GLsizeiptr size = 0; // 0 - whole buffer (glBindBufferBase)
+        };
+
+    private:
+
+        using buffer_index = list_index<BufferTargetList>;
+        using indexed_buffer_index = list_index<IndexedBufferTargetList>;
+        using texture_index = list_index<TextureTargetList>;
+        using capability_index = list_index<CapabilityList>;
+
+        std::array<GLuint, buffer_index::size> buffers_{};
+        std::array<std::array<indexed_binding, max_indexed_bindings>,
+            indexed_buffer_index::size> indexed_{};
+
+        GLuint vao_ = 0,
+            program_ = 0,
+            pipeline_ = 0;
+
+        // element array binding of each VAO, recorded when it is bound through the cache
+        std::unordered_map<GLuint, GLuint> elementBuffers_;
+
+        GLuint activeUnit_ = 0;
+        std::array<std::array<GLuint, texture_index::size>, max_texture_units> textures_{};
+        std::array<GLuint, max_texture_units> samplers_{};
+
+        GLuint drawFramebuffer_ = 0,
+            readFramebuffer_ = 0,
+            renderbuffer_ = 0;
+
+        // capabilities changed bypassing the cache are unknown until enabled or disabled
+        std::bitset<capability_index::size> capabilities_,
+            knownCapabilities_;
+
+        std::array<state_counter, (size_t)StateGroup::count> counters_{};
+
+        // glGet parameters for the targets, 0 - not supported
+        static GLenum binding_query(BufferTarget target)
+        {
+            switch (target)
+            {
+            case BufferTarget::array: return (GLenum)glBufferBinding::array_buffer_binding;
+            case BufferTarget::atomic_counter: return (GLenum)glBufferBinding::atomic_buffer_binding;
+            case BufferTarget::copy_read: return (GLenum)glBufferBinding::copy_read_buffer_binding;
+            case BufferTarget::copy_write: return (GLenum)glBufferBinding::copy_write_buffer_binding;
+            case BufferTarget::dispatch_indirect: return (GLenum)glBufferBinding::dispatch_indirect_buffer_binding;
+            case BufferTarget::draw_indirect: return (GLenum)glBufferBinding::draw_indirect_buffer_binding;
+            case BufferTarget::element_array: return (GLenum)glBufferBinding::element_array_buffer_binding;
+            case BufferTarget::pixel_pack: return (GLenum)glBufferBinding::pixel_pack_buffer_binding;
+            case BufferTarget::pixel_unpack: return (GLenum)glBufferBinding::pixel_unpack_buffer_binding;
+            case BufferTarget::shader_storage: return (GLenum)glBufferBinding::shader_storage_buffer_binding;
+            case BufferTarget::transform_feedback: return (GLenum)glBufferBinding::transform_feedback_buffer_binding;
+            case BufferTarget::uniform: return (GLenum)glBufferBinding::uniform_buffer_binding;
+            default: return 0;
+            }
+        }
+
+        static GLenum binding_query(TextureTarget target)
+        {
+            switch (target)
+            {
+            case TextureTarget::texture_1d: return GL_TEXTURE_BINDING_1D;
+            case TextureTarget::texture_1d_array: return GL_TEXTURE_BINDING_1D_ARRAY;
+            case TextureTarget::texture_2d: return GL_TEXTURE_BINDING_2D;
+            case TextureTarget::texture_2d_array: return GL_TEXTURE_BINDING_2D_ARRAY;
+            case TextureTarget::texture_2d_multisample: return GL_TEXTURE_BINDING_2D_MULTISAMPLE;
+            case TextureTarget::texture_2d_multisample_array: return GL_TEXTURE_BINDING_2D_MULTISAMPLE_ARRAY;
+            case TextureTarget::texture_3d: return GL_TEXTURE_BINDING_3D;
+            case TextureTarget::texture_rectangle: return GL_TEXTURE_BINDING_RECTANGLE;
+            case TextureTarget::texture_cube_map: return GL_TEXTURE_BINDING_CUBE_MAP;
+            case TextureTarget::texture_cube_map_array: return GL_TEXTURE_BINDING_CUBE_MAP_ARRAY;
+            case TextureTarget::texture_buffer: return GL_TEXTURE_BINDING_BUFFER;
+            default: return 0;
+            }
+        }
+
+        // returns true if the call must be issued
+        bool Update(GLuint& cached, GLuint val, StateGroup group)
+        {
+            state_counter& counter = counters_[(size_t)group];
+            if (cached == val)
+            {
+                ++counter.elided;
+                return false;
+            }
+
+            ++counter.issued;
+            cached = val;
+            return true;
+        }
+
+    public:
+
+        gl_state()
+        {
+            // enabled by default
+            capabilities_.set(capability_index::get(Capability::dither));
+            capabilities_.set(capability_index::get(Capability::multisample));
+            knownCapabilities_.set();
+        }
+
+        gl_state(const gl_state&) = delete;
+        gl_state& operator=(const gl_state&) = delete;
+
+        // state of the current context
+        static gl_state& Current();
+
+        ////////////////////////////////
+        // buffers
+        ////////////////////////////////
+
+        void BindBuffer(BufferTarget target, GLuint buffer)
+        {
+            size_t indx = buffer_index::get(target);
+            assert(indx < buffer_index::size && "Invalid buffer target!");
+
+            if (!Update(buffers_[indx], buffer, StateGroup::buffer))
+                return;
+
+            glBindBuffer((GLenum)target, buffer);
+
+            // element array binding is a part of the state of the bound VAO
+            if (target == BufferTarget::element_array && vao_ && vao_ != unknown)
+                elementBuffers_[vao_] = buffer;
+        }
+
+        GLuint Buffer(BufferTarget target) const
+        {
+            size_t indx = buffer_index::get(target);
+            assert(indx < buffer_index::size && "Invalid buffer target!");
+
+            return verify_binding(buffers_[indx], binding_query(target), "buffer");
+        }
+
+        // also binds the buffer to the generic binding point of the target
+        void BindBufferRange(BufferTarget target, GLuint index, GLuint buffer,
+            GLintptr offset = 0, GLsizeiptr size = 0)
+        {
+            size_t indx = indexed_buffer_index::get(target);
+            assert(indx < indexed_buffer_index::size && "Target is not indexed!");
+            assert(index < max_indexed_bindings && "Binding index exceeds the cache limit!");
+
+            indexed_binding& binding = indexed_[indx][index];
+            state_counter& counter = counters_[(size_t)StateGroup::buffer_indexed];
+
+            if (binding.buffer == buffer &&
+                binding.offset == offset &&
+                binding.size == size)
+            {
+                ++counter.elided;
+                return;
+            }
+
+            ++counter.issued;
+            binding = indexed_binding{ buffer, offset, size };
+            buffers_[buffer_index::get(target)] = buffer;
+
+            if (size)
+                glBindBufferRange((GLenum)target, index, buffer, offset, size);
+            else
+                glBindBufferBase((GLenum)target, index, buffer);
+        }
+
+        void BindBufferBase(BufferTarget target, GLuint index, GLuint buffer)
+        {
+            BindBufferRange(target, index, buffer);
+        }
+
+        const indexed_binding& BufferIndexed(BufferTarget target, GLuint index) const
+        {
+            size_t indx = indexed_buffer_index::get(target);
+            assert(indx < indexed_buffer_index::size && "Target is not indexed!");
+            assert(index < max_indexed_bindings && "Binding index exceeds the cache limit!");
+
+            const indexed_binding& binding = indexed_[indx][index];
+            if constexpr (state_policy == StatePolicy::verify)
+            {
+                GLint actual = 0;
+                glGetIntegeri_v(binding_query(target), index, &actual);
+                if (binding.buffer != unknown && (GLuint)actual != binding.buffer)
+                {
+                    ++state_mismatches();
+                    std::cerr << "glt state mismatch: indexed buffer " << index << " cached " <<
+                        binding.buffer << ", actual " << actual << std::endl;
+                }
+            }
+
+            return binding;
+        }
+
+        ////////////////////////////////
+        // vertex arrays and programs
+        ////////////////////////////////
+
+        // element array binding is a part of VAO state
+        void BindVertexArray(GLuint vao)
+        {
+            if (!Update(vao_, vao, StateGroup::vao))
+                return;
+
+            glBindVertexArray(vao);
+            buffers_[list_index_v<BufferTargetList, BufferTarget::element_array>] =
+                vao ? ElementBuffer(vao) : 0;
+        }
+
+        // element array buffer of the VAO, unknown if it has not been bound through the cache
+        GLuint ElementBuffer(GLuint vao) const
+        {
+            auto found = elementBuffers_.find(vao);
+            return found != elementBuffers_.end() ? found->second : unknown;
+        }
+
+        GLuint VertexArray() const
+        {
+            return verify_binding(vao_, GL_VERTEX_ARRAY_BINDING, "vertex array");
+        }
+
+        void UseProgram(GLuint program)
+        {
+            if (Update(program_, program, StateGroup::program))
+                glUseProgram(program);
+        }
+
+        GLuint Program() const
+        {
+            return verify_binding(program_, GL_CURRENT_PROGRAM, "program");
+        }
+
+        void BindProgramPipeline(GLuint pipeline)
+        {
+            if (Update(pipeline_, pipeline, StateGroup::program_pipeline))
+                glBindProgramPipeline(pipeline);
+        }
+
+        GLuint ProgramPipeline() const
+        {
+            return verify_binding(pipeline_, GL_PROGRAM_PIPELINE_BINDING, "program pipeline");
+        }
+
+        ////////////////////////////////
+        // textures and samplers
+        ////////////////////////////////
+
+        void ActiveTexture(GLuint unit)
+        {
+            assert(unit < max_texture_units && "Texture unit exceeds the cache limit!");
+
+            if (Update(activeUnit_, unit, StateGroup::active_texture))
+                glActiveTexture(GL_TEXTURE0 + unit);
+        }
+
+        GLuint ActiveUnit() const
+        {
+            if constexpr (state_policy == StatePolicy::verify)
+            {
+                GLint actual = 0;
+                glGetIntegerv(GL_ACTIVE_TEXTURE, &actual);
+                if ((GLuint)actual != GL_TEXTURE0 + activeUnit_)
+                {
+                    ++state_mismatches();
+                    std::cerr << "glt state mismatch: active texture unit cached " << activeUnit_ <<
+                        ", actual " << actual - GL_TEXTURE0 << std::endl;
+                }
+            }
+
+            return activeUnit_;
+        }
+
+        // bind to the active texture unit
+        void BindTexture(TextureTarget target, GLuint texture)
+        {
+            size_t indx = texture_index::get(target);
+            assert(indx < texture_index::size && "Invalid texture target!");
+
+            if (Update(textures_[activeUnit_][indx], texture, StateGroup::texture))
+                glBindTexture((GLenum)target, texture);
+        }
+
+        // switches active texture unit only if the texture is not bound to the unit yet
+        void BindTexture(GLuint unit, TextureTarget target, GLuint texture)
+        {
+            assert(unit < max_texture_units && "Texture unit exceeds the cache limit!");
+
+            if (Texture(unit, target) == texture)
+            {
+                ++counters_[(size_t)StateGroup::texture].elided;
+                return;
+            }
+
+            ActiveTexture(unit);
+            BindTexture(target, texture);
+        }
+
+        GLuint Texture(GLuint unit, TextureTarget target) const
+        {
+            size_t indx = texture_index::get(target);
+            assert(indx < texture_index::size && "Invalid texture target!");
+            assert(unit < max_texture_units && "Texture unit exceeds the cache limit!");
+
+            // only the active unit can be queried without switching units
+            return unit == activeUnit_ ?
+                verify_binding(textures_[unit][indx], binding_query(target), "texture") :
+                textures_[unit][indx];
+        }
+
+        // texture bound to the active unit
+        GLuint Texture(TextureTarget target) const
+        {
+            return Texture(activeUnit_, target);
+        }
+
+        void BindSampler(GLuint unit, GLuint sampler)
+        {
+            assert(unit < max_texture_units && "Texture unit exceeds the cache limit!");
+
+            if (Update(samplers_[unit], sampler, StateGroup::sampler))
+                glBindSampler(unit, sampler);
+        }
+
+        GLuint Sampler(GLuint unit) const
+        {
+            assert(unit < max_texture_units && "Texture unit exceeds the cache limit!");
+            return unit == activeUnit_ ?
+                verify_binding(samplers_[unit], GL_SAMPLER_BINDING, "sampler") :
+                samplers_[unit];
+        }
+
+        ////////////////////////////////
+        // framebuffers
+        ////////////////////////////////
+
+        void BindFramebuffer(FrameBufTarget target, GLuint framebuffer)
+        {
+            switch (target)
+            {
+            case FrameBufTarget::draw:
+                if (Update(drawFramebuffer_, framebuffer, StateGroup::framebuffer))
+                    glBindFramebuffer((GLenum)target, framebuffer);
+                break;
+            case FrameBufTarget::read:
+                if (Update(readFramebuffer_, framebuffer, StateGroup::framebuffer))
+                    glBindFramebuffer((GLenum)target, framebuffer);
+                break;
+            case FrameBufTarget::framebuffer:
+                if (drawFramebuffer_ == framebuffer && readFramebuffer_ == framebuffer)
+                {
+                    ++counters_[(size_t)StateGroup::framebuffer].elided;
+                    break;
+                }
+
+                ++counters_[(size_t)StateGroup::framebuffer].issued;
+                drawFramebuffer_ = readFramebuffer_ = framebuffer;
+                glBindFramebuffer((GLenum)target, framebuffer);
+                break;
+            default:
+                assert(false && "Invalid framebuffer target!");
+            }
+        }
+
+        // for FrameBufTarget::framebuffer returns handle only if bound to both targets
+        GLuint Framebuffer(FrameBufTarget target) const
+        {
+            switch (target)
+            {
+            case FrameBufTarget::draw:
+                return verify_binding(drawFramebuffer_, GL_DRAW_FRAMEBUFFER_BINDING, "draw framebuffer");
+            case FrameBufTarget::read:
+                return verify_binding(readFramebuffer_, GL_READ_FRAMEBUFFER_BINDING, "read framebuffer");
+            case FrameBufTarget::framebuffer:
+                return drawFramebuffer_ == readFramebuffer_ ? drawFramebuffer_ : unknown;
+            default:
+                assert(false && "Invalid framebuffer target!");
+                return unknown;
+            }
+        }
+
+        void BindRenderbuffer(GLuint renderbuffer)
+        {
+            if (Update(renderbuffer_, renderbuffer, StateGroup::renderbuffer))
+                glBindRenderbuffer((GLenum)RenderBufferTarget::renderbuffer, renderbuffer);
+        }
+
+        GLuint Renderbuffer() const
+        {
+            return verify_binding(renderbuffer_, GL_RENDERBUFFER_BINDING, "renderbuffer");
+        }
+
+        ////////////////////////////////
+        // capabilities
+        ////////////////////////////////
+
+        void Enable(Capability cap)
+        {
+            size_t indx = capability_index::get(cap);
+            assert(indx < capability_index::size && "Invalid capability!");
+
+            state_counter& counter = counters_[(size_t)StateGroup::capability];
+            if (knownCapabilities_[indx] && capabilities_[indx])
+            {
+                ++counter.elided;
+                return;
+            }
+
+            ++counter.issued;
+            capabilities_.set(indx);
+            knownCapabilities_.set(indx);
+            glEnable((GLenum)cap);
+        }
+
+        void Disable(Capability cap)
+        {
+            size_t indx = capability_index::get(cap);
+            assert(indx < capability_index::size && "Invalid capability!");
+
+            state_counter& counter = counters_[(size_t)StateGroup::capability];
+            if (knownCapabilities_[indx] && !capabilities_[indx])
+            {
+                ++counter.elided;
+                return;
+            }
+
+            ++counter.issued;
+            capabilities_.reset(indx);
+            knownCapabilities_.set(indx);
+            glDisable((GLenum)cap);
+        }
+
+        bool IsEnabled(Capability cap) const
+        {
+            size_t indx = capability_index::get(cap);
+            assert(indx < capability_index::size && "Invalid capability!");
+
+            if (!knownCapabilities_[indx])
+                return glIsEnabled((GLenum)cap);
+
+            if constexpr (state_policy == StatePolicy::verify)
+            {
+                if ((bool)glIsEnabled((GLenum)cap) != capabilities_[indx])
+                {
+                    ++state_mismatches();
+                    std::cerr << "glt state mismatch: capability " << (int)cap << " cached " <<
+                        capabilities_[indx] << std::endl;
+                }
+            }
+
+            return capabilities_[indx];
+        }
+
+        ////////////////////////////////
+        // deleted objects
+        // OpenGL unbinds deleted objects from the current context, however deletion
+        // may be deferred (see HandlePool), thus the bindings become unknown
+        ////////////////////////////////
+
+        void ForgetBuffer(GLuint buffer)
+        {
+            for (GLuint& bound : buffers_)
+                if (bound == buffer)
+                    bound = unknown;
+
+            for (auto& bindings : indexed_)
+                for (indexed_binding& binding : bindings)
+                    if (binding.buffer == buffer)
+                        binding = indexed_binding{ unknown, 0, 0 };
+
+            // VAOs that are not bound keep referencing the deleted buffer, not the reused name
+            for (auto& element : elementBuffers_)
+                if (element.second == buffer)
+                    element.second = unknown;
+        }
+
+        void ForgetVertexArray(GLuint vao)
+        {
+            elementBuffers_.erase(vao);
+
+            if (vao_ == vao)
+            {
+                vao_ = unknown;
+                buffers_[list_index_v<BufferTargetList, BufferTarget::element_array>] = unknown;
+            }
+        }
+
+        void ForgetProgramPipeline(GLuint pipeline)
+        {
+            if (pipeline_ == pipeline)
+                pipeline_ = unknown;
+        }
+
+        void ForgetTexture(GLuint texture)
+        {
+            for (auto& unit : textures_)
+                for (GLuint& bound : unit)
+                    if (bound == texture)
+                        bound = unknown;
+        }
+
+        void ForgetSampler(GLuint sampler)
+        {
+            for (GLuint& bound : samplers_)
+                if (bound == sampler)
+                    bound = unknown;
+        }
+
+        void ForgetFramebuffer(GLuint framebuffer)
+        {
+            if (drawFramebuffer_ == framebuffer)
+                drawFramebuffer_ = unknown;
+            if (readFramebuffer_ == framebuffer)
+                readFramebuffer_ = unknown;
+        }
+
+        void ForgetRenderbuffer(GLuint renderbuffer)
+        {
+            if (renderbuffer_ == renderbuffer)
+                renderbuffer_ = unknown;
+        }
+
+        // dispatches by the type of the deleted object
+        template <typename eTargetType>
+        void Forget(GLuint name)
+        {
+            if constexpr (std::is_same_v<eTargetType, BufferTarget>)
+                ForgetBuffer(name);
+            else if constexpr (std::is_same_v<eTargetType, VAOTarget>)
+                ForgetVertexArray(name);
+            else if constexpr (std::is_same_v<eTargetType, ProgramPipeLineTarget>)
+                ForgetProgramPipeline(name);
+            else if constexpr (std::is_same_v<eTargetType, TextureTarget>)
+                ForgetTexture(name);
+            else if constexpr (std::is_same_v<eTargetType, SamplerTarget>)
+                ForgetSampler(name);
+            else if constexpr (std::is_same_v<eTargetType, FrameBufTarget>)
+                ForgetFramebuffer(name);
+            else if constexpr (std::is_same_v<eTargetType, RenderBufferTarget>)
+                ForgetRenderbuffer(name);
+        }
+
+        // marks all bindings as unknown, next Bind calls are always issued.
+        // Use after OpenGL state has been changed bypassing the cache, or when
+        // objects might have been deleted in another context.
+        void Invalidate()
+        {
+            buffers_.fill(unknown);
+            for (auto& bindings : indexed_)
+                bindings.fill(indexed_binding{ unknown, 0, 0 });
+
+            vao_ = program_ = pipeline_ = unknown;
+            elementBuffers_.clear();
+
+            // active unit indexes the cache, thus it is reset instead
+            activeUnit_ = 0;
+            glActiveTexture(GL_TEXTURE0);
+            for (auto& unit : textures_)
+                unit.fill(unknown);
+            samplers_.fill(unknown);
+
+            drawFramebuffer_ = readFramebuffer_ = renderbuffer_ = unknown;
+            knownCapabilities_.reset();
+        }
+
+        ////////////////////////////////
+        // counters
+        ////////////////////////////////
+
+        const state_counter& Counter(StateGroup group) const
+        {
+            return counters_[(size_t)group];
+        }
+
+        state_counter Total() const
+        {
+            state_counter total;
+            for (const state_counter& counter : counters_)
+            {
+                total.issued += counter.issued;
+                total.elided += counter.elided;
+            }
+            return total;
+        }
+
+        void ResetCounters()
+        {
+            counters_.fill(state_counter());
+        }
+    };
+
+    inline void ActiveTexture(GLuint unit)
+    {
+        gl_state::Current().ActiveTexture(unit);
+    }
+
+    inline void Enable(Capability cap)
+    {
+        gl_state::Current().Enable(cap);
+    }
+
+    inline void Disable(Capability cap)
+    {
+        gl_state::Current().Disable(cap);
+    }
+
+}
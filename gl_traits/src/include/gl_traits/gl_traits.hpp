@@ -58,16 +58,28 @@ TODO: analize possible VertexArrayPointer assignment routines
 /////////////////////////
 
 #include "basic_types.hpp"
+#include "context.hpp"
 
 #include "buffer_traits.hpp"
 #include "shader_traits.hpp"
+#include "shader_variants.hpp"
 #include "program_traits.hpp"
+#include "program_pipeline.hpp"
+#include "render_queue.hpp"
+#include "command_list.hpp"
 
 // ??
 // sequence
 // uniform
 // program
 #include "Texture.hpp"
+#include "pixel_upload.hpp"
+#include "texture_packer.hpp"
+#include "texture_loader.hpp"
+#include "texture_cache.hpp"
+#include "sampler.hpp"
+
+#include "upload_thread.hpp"
 
 namespace glt
 {
@@ -2,7 +2,9 @@
 
 #include "glslt_traits.hpp"
 #include "enums.hpp"
+#include "context.hpp"
 
+#include <atomic>
 #include <map>
 
 namespace glt
@@ -14,10 +16,15 @@ namespace glt
     template <typename eTargetType>
     class handle_accessor;
 
+    template <typename eTargetType>
+    class SharedHandle;
+
 	/*
 	Handle is unique. Frees OpenGL resources on destruction.
+	Handles must be destroyed on the thread the context is current on, unless they are
+	retired to a queue (see Context::EnableDeferredDeletion).
 
-	Need to implement shared handle?
+	See SharedHandle for objects shared between wrappers.
 	*/
     template <typename eTargetType>
     class Handle
@@ -27,13 +34,29 @@ namespace glt
 
         friend struct AllocatorSpecific<eTargetType>;
         friend class handle_accessor<eTargetType>;
+        friend class SharedHandle<eTargetType>;
 
 		void DestroyHandle()
 		{
 			// TODO: do i need to check?
 			assert(*ppDeleteFunc && "Pointers to OpenGL deleter functions have not been initialiized!");
 
-			// TODO: Unbind from bound_handle, OpenGL ubinds automaticallu after deleting
+			// deleted once the GPU has finished using the object (see Context::EnableDeferredDeletion)
+			if (RetireQueue *queue = Context::Retiring())
+			{
+				queue->Retire<eTargetType>(handle_);
+				return;
+			}
+
+			// OpenGL unbinds deleted objects
+			gl_state::Current().Forget<eTargetType>(handle_);
+
+			if constexpr (is_poolable_v<eTargetType>)
+				if (HandlePool<eTargetType> *pool = Context::Current().Pool<eTargetType>())
+				{
+					pool->Release(handle_);
+					return;
+				}
 
 			// check function signature for arguments
 			if constexpr (std::is_same_v<void(APIENTRYP *)(GLsizei, const GLuint*), pp_gl_deleter<eTargetType>::value_type>)
@@ -122,6 +145,131 @@ namespace glt
 
     };
 
+	// tag for constructors of wrappers sharing an OpenGL object
+	struct share_tag {};
+
+	/*
+	Reference-counted handle. Frees OpenGL resources when the last SharedHandle
+	referencing them is destroyed.
+
+	SharedHandle owns the Handle directly until it is copied for the first time, thus
+	objects that are never shared do not allocate a reference counter.
+	Once shared, the counter owns the object and handle_ keeps the name only, thus handle_
+	is not modified by copies and the same SharedHandle may be copied concurrently.
+	*/
+	template <typename eTargetType>
+	class SharedHandle
+	{
+		struct shared_block
+		{
+			std::atomic<size_t> refs;
+			Handle<eTargetType> handle;
+		};
+
+		Handle<eTargetType> handle_{ 0 };
+		mutable std::atomic<shared_block*> block_{ nullptr };
+
+		// the first of concurrent copies allocates the counter
+		shared_block* Promote() const
+		{
+			shared_block *block = block_.load(std::memory_order_acquire);
+			if (block)
+				return block;
+
+			shared_block *created = new shared_block{ {1}, Handle<eTargetType>(handle_.handle_) };
+			if (block_.compare_exchange_strong(block, created,
+				std::memory_order_acq_rel, std::memory_order_acquire))
+				return created;
+
+			// name is owned by the counter of another copy
+			created->handle.handle_ = 0;
+			delete created;
+			return block;
+		}
+
+		void Release()
+		{
+			shared_block *block = block_.exchange(nullptr, std::memory_order_acq_rel);
+			if (!block)
+				return;
+
+			// deleted by the counter
+			handle_.handle_ = 0;
+
+			if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				delete block;
+		}
+
+	public:
+
+		SharedHandle(Handle<eTargetType>&& handle)
+			: handle_(std::move(handle))
+		{}
+
+		SharedHandle(const SharedHandle& other)
+			: handle_(other.handle_.handle_),
+			block_(other.Promote())
+		{
+			block_.load(std::memory_order_relaxed)->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		SharedHandle(SharedHandle&& other)
+			: handle_(std::move(other.handle_)),
+			block_(other.block_.exchange(nullptr, std::memory_order_relaxed))
+		{}
+
+		SharedHandle& operator=(SharedHandle other)
+		{
+			Release();
+
+			handle_ = std::move(other.handle_);
+			block_.store(other.block_.exchange(nullptr, std::memory_order_relaxed),
+				std::memory_order_relaxed);
+
+			return *this;
+		}
+
+		~SharedHandle()
+		{
+			Release();
+		}
+
+		// holds the name of the object whether it is shared or not
+		const Handle<eTargetType>& Get() const
+		{
+			return handle_;
+		}
+
+		// number of SharedHandles referencing the object
+		size_t UseCount() const
+		{
+			if (shared_block *block = block_.load(std::memory_order_acquire))
+				return block->refs.load(std::memory_order_relaxed);
+
+			return handle_ ? 1 : 0;
+		}
+
+		bool operator==(GLuint raw_handle) const
+		{
+			return Get() == raw_handle;
+		}
+
+		bool operator!=(GLuint raw_handle) const
+		{
+			return !operator==(raw_handle);
+		}
+
+		bool IsValid() const
+		{
+			return Get().IsValid();
+		}
+
+		operator bool() const
+		{
+			return IsValid();
+		}
+	};
+
 	// traits for classes that has handle accessor functions
 	template <class T, typename = std::void_t<>>
 	struct has_GetHandle : std::false_type {};
@@ -139,18 +287,7 @@ namespace glt
     using HandleTexture = Handle<TextureTarget>;
 	using HandleFrameBuffer = Handle<FrameBufTarget>;
 	using HandleRenderBuffer = Handle<RenderBufferTarget>;
-
-	using TargetTypes = std::tuple<BufferTarget,
-		FrameBufTarget,
-		TextureTarget,
-		VAOTarget,
-		TransformFeedBackTarget,
-		QueryTarget,
-		ProgramPipeLineTarget,
-		RenderBufferTarget,
-		SamplerTarget,
-		ShaderTarget,
-		ProgramTarget>;
+	using HandleSampler = Handle<SamplerTarget>;
 
 
     // TODO: add responsibility to delete handle?
@@ -171,7 +308,14 @@ namespace glt
                     "functions have not been initialiized!");
                     */
             GLuint h = 0;
-            if constexpr (std::is_same_v<void(APIENTRYP *)(GLsizei, GLuint*), pp_gl_allocator<eTargetType>::value_type>)
+            if constexpr (is_poolable_v<eTargetType>)
+            {
+                if (HandlePool<eTargetType> *pool = Context::Current().Pool<eTargetType>())
+                    h = pool->Acquire();
+                else
+                    (*ppAllocFunc)(1, &h);
+            }
+            else if constexpr (std::is_same_v<void(APIENTRYP *)(GLsizei, GLuint*), pp_gl_allocator<eTargetType>::value_type>)
             {
                 (*ppAllocFunc)(1, &h);
             }
@@ -251,6 +395,10 @@ namespace glt
 			: raw_handle_(handle)
 		{}
 
+		handle_accessor(const SharedHandle<eTargetType>& handle) noexcept
+			: raw_handle_(handle.Get())
+		{}
+
 		constexpr operator GLint() const noexcept
 		{
 			assert(raw_handle_ && "handle_accessor::Invalid handle!");
@@ -284,17 +432,49 @@ namespace glt
 
     */
 
-    // TODO: replace with map?
+    // binding state is stored in the context's state cache (see gl_state)
     template <typename eTargetType, eTargetType target>
     class bound_handle_base
     {
     protected:
+        // for targets not covered by gl_state
         inline static GLuint raw_handle_ = 0;
 
         static_assert(has_func_bind_v<eTargetType>, "Typename doesn't have a glBind function");
 
         // property cannot be retrieved using glGet(..._BINDING)
         static_assert(has_gl_binding_v<target>, "Target can not be bound");
+
+        static void BindRaw(GLuint raw)
+        {
+            if constexpr (std::is_same_v<eTargetType, BufferTarget>)
+                gl_state::Current().BindBuffer(target, raw);
+            else if constexpr (std::is_same_v<eTargetType, TextureTarget>)
+                gl_state::Current().BindTexture(target, raw);
+            else if constexpr (std::is_same_v<eTargetType, FrameBufTarget>)
+                gl_state::Current().BindFramebuffer(target, raw);
+            else
+            {
+                // TODO: remove check from here. Assign function pointers to default function
+                assert(*ppBindFunc && "OpenGL Bind function has not been initialized!");
+
+                (*ppBindFunc)((GLenum)target, raw);
+                raw_handle_ = raw;
+            }
+        }
+
+        static GLuint BoundRaw()
+        {
+            if constexpr (std::is_same_v<eTargetType, BufferTarget>)
+                return gl_state::Current().Buffer(target);
+            else if constexpr (std::is_same_v<eTargetType, TextureTarget>)
+                return gl_state::Current().Texture(target);
+            else if constexpr (std::is_same_v<eTargetType, FrameBufTarget>)
+                return gl_state::Current().Framebuffer(target);
+            else
+                return verify_binding(raw_handle_, (GLenum)binding, "handle");
+        }
+
     public:
 
         constexpr static auto ppBindFunc = pp_gl_binder_v<eTargetType>;
@@ -302,39 +482,26 @@ namespace glt
 
         static void Bind(tag_v<target>, const IBindable<eTargetType>& obj)
         {
-            const Handle<eTargetType>& handle = obj.GetHandle();
-
-			// TODO: remove check from here. Assign function pointers to default function
-            assert(*ppBindFunc && "OpenGL Bind function has not been initialized!");
-
-            (*ppBindFunc)((GLenum)target, handle_accessor(handle));
-            raw_handle_ = handle_accessor(handle);
+            BindRaw(handle_accessor(obj.GetHandle()));
         }
 
         static void UnBind(tag_v<target>, const IBindable<eTargetType>& obj)
         {
             const Handle<eTargetType>& handle = obj.GetHandle();
-            if (handle != raw_handle_)
+            if (handle != BoundRaw())
             {
                 assert(false && "Unbinding handle that is not bound!");
                 throw("Unbinding handle that is not bound!");
             }
-            assert(*ppBindFunc && "OpenGL Bind function has not been initialized!");
 
-            (*ppBindFunc)((GLenum)target, 0);
-            raw_handle_ = 0;
+            BindRaw(0);
         }
 
         static bool IsBound(tag_v<target>, const IBindable<eTargetType>& obj)
         {
             const Handle<eTargetType>& handle = obj.GetHandle();
-            // TODO: assert that returned by glGet object is equal to raw_handle_;
-            // TODO: make an independent wrapper
-            GLint res = 0;
-            glGetIntegerv((GLenum)binding, &res);
-            assert(res == raw_handle_);
-
-            return bool(handle == raw_handle_);
+            // cached state, verified with glGet depending on GLT_STATE_POLICY
+            return bool(handle == BoundRaw());
         }
     };
 
@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+FNV-1a hashing of data to be used as keys of the caches (program binaries, etc).
+Hashes are not cryptographic and are stable across runs and platforms.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace glt
+{
+    using hash_t = std::uint64_t;
+
+    constexpr inline hash_t fnv1a_basis = 14695981039346656037ull;
+    constexpr inline hash_t fnv1a_prime = 1099511628211ull;
+
+    // continues the hash of the preceding data
+    inline hash_t HashBytes(const void *data, size_t size, hash_t hash = fnv1a_basis)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i != size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= fnv1a_prime;
+        }
+
+        return hash;
+    }
+
+    constexpr hash_t HashString(std::string_view str, hash_t hash = fnv1a_basis)
+    {
+        for (char c : str)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= fnv1a_prime;
+        }
+
+        return hash;
+    }
+
+    // order dependent
+    constexpr hash_t HashCombine(hash_t hash, hash_t other)
+    {
+        for (size_t i = 0; i != sizeof(hash_t); ++i)
+        {
+            hash ^= static_cast<unsigned char>(other >> (i * 8));
+            hash *= fnv1a_prime;
+        }
+
+        return hash;
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+/*
+Pool of OpenGL object names for a type of objects.
+
+Names are generated in blocks with a single glGen*(n, ...) call and handed out one
+by one. Released names are deleted in batches with a single glDelete*(n, ...) call.
+Released names are not reused: an object that has been bound once keeps its state
+(storage, parameters, etc), which can not be reset for every type of objects.
+
+Deletion of released objects is deferred until the batch is full or Flush is called,
+thus they may remain bound in OpenGL until then (see gl_state::Forget*).
+
+Pools are opt-in and owned by a Context (see Context::EnablePool).
+*/
+
+#include "type_converions.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace glt
+{
+    // objects generated and deleted with glGen*(n, ...) and glDelete*(n, ...)
+    template <typename eTargetType>
+    constexpr inline bool is_poolable_v =
+        std::is_invocable_v<std::remove_pointer_t<decltype(pp_gl_allocator_v<eTargetType>)>,
+            GLsizei, GLuint*> &&
+        std::is_invocable_v<std::remove_pointer_t<decltype(pp_gl_deleter_v<eTargetType>)>,
+            GLsizei, const GLuint*>;
+
+    template <typename eTargetType>
+    class HandlePool
+    {
+        static_assert(is_poolable_v<eTargetType>,
+            "Objects can not be generated or deleted in batches!");
+
+        constexpr static auto ppAllocFunc = pp_gl_allocator_v<eTargetType>;
+        constexpr static auto ppDeleteFunc = pp_gl_deleter_v<eTargetType>;
+
+        size_t blockSize_,
+            deleteBatch_;
+
+        std::vector<GLuint> free_,
+            released_;
+
+        size_t generateCalls_ = 0,
+            deleteCalls_ = 0;
+
+    public:
+
+        HandlePool(size_t blockSize = 64, size_t deleteBatch = 64)
+            : blockSize_(blockSize),
+            deleteBatch_(deleteBatch)
+        {
+            assert(blockSize_ && deleteBatch_ && "Invalid pool sizes!");
+
+            free_.reserve(blockSize_);
+            released_.reserve(deleteBatch_);
+        }
+
+        HandlePool(const HandlePool&) = delete;
+        HandlePool& operator=(const HandlePool&) = delete;
+
+        // context the pool belongs to must be current
+        ~HandlePool()
+        {
+            released_.insert(released_.end(), free_.begin(), free_.end());
+            free_.clear();
+            Flush();
+        }
+
+        GLuint Acquire()
+        {
+            if (free_.empty())
+                Generate();
+
+            GLuint name = free_.back();
+            free_.pop_back();
+            return name;
+        }
+
+        void Release(GLuint name)
+        {
+            assert(name && "Releasing invalid name!");
+
+            released_.push_back(name);
+            if (released_.size() >= deleteBatch_)
+                Flush();
+        }
+
+        // deletes released objects
+        void Flush()
+        {
+            if (released_.empty())
+                return;
+
+            (*ppDeleteFunc)((GLsizei)released_.size(), released_.data());
+            released_.clear();
+            ++deleteCalls_;
+        }
+
+        size_t Available() const
+        {
+            return free_.size();
+        }
+
+        size_t Pending() const
+        {
+            return released_.size();
+        }
+
+        size_t GenerateCalls() const
+        {
+            return generateCalls_;
+        }
+
+        size_t DeleteCalls() const
+        {
+            return deleteCalls_;
+        }
+
+    private:
+
+        void Generate()
+        {
+            // names are handed out from the back
+            free_.resize(blockSize_);
+            (*ppAllocFunc)((GLsizei)blockSize_, free_.data());
+            std::reverse(free_.begin(), free_.end());
+            ++generateCalls_;
+        }
+    };
+
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+/*
+Ring of staging memory for asynchronous texture uploads.
+
+The ring is a pixel_unpack Buffer persistently and coherently mapped (OpenGL 4.4 or
+ARB_buffer_storage). Pixels are written to the mapped memory and textures are sourced
+from the offset of the written data, thus glTexSubImage* returns without copying the
+client memory:
+
+    ring.Bind();
+    texture.SubImage(0, width, height, format, type, ring.Write(pixels, bytes));
+    ring.Fence();
+    ring.UnBind();
+
+Regions are reused once the fence following their upload has signalled. Allocation
+waits only if the ring wraps onto a region still read by the GPU. Allocations made since
+the last fence must fit in the ring together.
+Must be used on the thread the context is current on.
+*/
+
+#include "buffer_traits.hpp"
+#include "texture_traits.hpp"
+
+#include <cstring>
+#include <deque>
+
+namespace glt
+{
+    class PixelUploadRing
+    {
+        // wrapped - [begin, size) and [0, end)
+        struct region
+        {
+            GLsync fence;
+            size_t begin,
+                end;
+            bool wrapped;
+        };
+
+        Buffer<GLubyte> buffer_;
+        unsigned char *mapped_ = nullptr;
+        size_t size_;
+
+        size_t head_ = 0;
+
+        // allocated since the last fence, not fenced on wrapping as their uploads
+        // may not have been issued yet
+        size_t pendingBegin_ = 0;
+        bool pending_ = false,
+            pendingWrapped_ = false;
+
+        std::deque<region> fenced_;
+        size_t waits_ = 0;
+
+    public:
+
+        struct staging
+        {
+            unsigned char *data;
+            unpack_offset offset;
+        };
+
+        explicit PixelUploadRing(size_t size)
+            : size_(size)
+        {
+            assert(size_ && "Empty upload ring!");
+
+            constexpr GLbitfield access = (GLbitfield)MapAccessBit::write |
+                (GLbitfield)MapAccessBit::persistent |
+                (GLbitfield)MapAccessBit::coherent;
+
+            buffer_.Bind(BufferTarget::pixel_unpack);
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size_, nullptr, access);
+            mapped_ = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0,
+                (GLsizeiptr)size_, access);
+            buffer_.UnBind();
+
+            assert(mapped_ && "Failed to map upload ring!");
+        }
+
+        PixelUploadRing(const PixelUploadRing&) = delete;
+        PixelUploadRing& operator=(const PixelUploadRing&) = delete;
+
+        // buffer is unmapped when deleted, waits for the pending uploads
+        ~PixelUploadRing()
+        {
+            Fence();
+            while (!fenced_.empty())
+                Retire(true);
+        }
+
+        // memory for the pixels of a single upload
+        staging Allocate(size_t bytes, size_t alignment = 4)
+        {
+            assert(bytes <= size_ && "Upload exceeds the size of the ring!");
+
+            size_t offset = (head_ + alignment - 1) / alignment * alignment;
+            if (offset + bytes > size_)
+            {
+                // allocations never wrap around the end of the ring
+                assert(!pendingWrapped_ && "Uploads since the last fence exceed the ring!");
+                pendingWrapped_ = pending_;
+                offset = 0;
+            }
+
+            assert((!pendingWrapped_ || offset + bytes <= pendingBegin_) &&
+                "Uploads since the last fence exceed the ring!");
+
+            // fences signal in order, regions older than the overlapped ones are retired first
+            while (InFlight(unpack_offset{ offset }, bytes))
+                Retire(true);
+
+            if (!pending_)
+            {
+                pendingBegin_ = offset;
+                pending_ = true;
+            }
+
+            head_ = offset + bytes;
+            return staging{ mapped_ + offset, unpack_offset{ offset } };
+        }
+
+        // copies the pixels to the ring
+        unpack_offset Write(const void *pixels, size_t bytes, size_t alignment = 4)
+        {
+            staging mem = Allocate(bytes, alignment);
+            std::memcpy(mem.data, pixels, bytes);
+            return mem.offset;
+        }
+
+        // must follow the commands reading the regions allocated since the last fence
+        void Fence()
+        {
+            if (!pending_)
+                return;
+
+            fenced_.push_back(region{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+                pendingBegin_, head_, pendingWrapped_ });
+            pending_ = pendingWrapped_ = false;
+
+            // regions which have been read are released without waiting
+            while (!fenced_.empty() && Retire(false));
+        }
+
+        void Bind()
+        {
+            buffer_.Bind(BufferTarget::pixel_unpack);
+        }
+
+        void UnBind()
+        {
+            buffer_.UnBind();
+        }
+
+        bool IsBound() const
+        {
+            return buffer_.IsBound();
+        }
+
+        size_t Size() const
+        {
+            return size_;
+        }
+
+        // number of allocations that had to wait for the GPU
+        size_t Waits() const
+        {
+            return waits_;
+        }
+
+        // the range may still be read by fenced uploads
+        bool InFlight(unpack_offset offset, size_t bytes) const
+        {
+            for (const region& r : fenced_)
+                if (Overlaps(r, offset.offset, offset.offset + bytes))
+                    return true;
+
+            return false;
+        }
+
+    private:
+
+        static bool Overlaps(const region& r, size_t begin, size_t end)
+        {
+            if (r.wrapped)
+                return begin < r.end || end > r.begin;
+
+            return r.begin < end && begin < r.end;
+        }
+
+        bool Retire(bool wait)
+        {
+            region& r = fenced_.front();
+
+            GLenum res = glClientWaitSync(r.fence, 0, 0);
+            if (wait && res == GL_TIMEOUT_EXPIRED)
+            {
+                ++waits_;
+                while (res == GL_TIMEOUT_EXPIRED)
+                    res = glClientWaitSync(r.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            }
+
+            if (res == GL_TIMEOUT_EXPIRED)
+                return false;
+
+            assert(res != GL_WAIT_FAILED && "Failed to wait for upload fence!");
+
+            glDeleteSync(r.fence);
+            fenced_.pop_front();
+            return true;
+        }
+    };
+
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+/*
+On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+
+Binaries are keyed by the hash of the shader sources together with the vendor,
+renderer and version strings of the driver, thus an updated driver does not load
+stale binaries. A binary rejected by the driver is removed and the program is
+compiled and linked from the sources (see Program::Link).
+
+Files are written to a temporary file first and then renamed, so that other
+processes (or a crash) never observe a partially written binary.
+
+Requires OpenGL 4.1 or ARB_get_program_binary, otherwise the cache always misses.
+*/
+
+#include "basic_types.hpp"
+#include "gltHash.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace glt
+{
+    class ProgramBinaryCache
+    {
+        constexpr static std::uint32_t magic = 0x424C5447; // "GLTB"
+
+        struct file_header
+        {
+            std::uint32_t magic;
+            std::uint32_t format;
+            std::uint64_t key;
+            std::uint64_t length;
+        };
+
+        std::filesystem::path directory_;
+
+        // driver strings, hashed on first use
+        hash_t driver_ = 0;
+
+        size_t hits_ = 0,
+            misses_ = 0;
+
+    public:
+
+        explicit ProgramBinaryCache(std::filesystem::path directory)
+            : directory_(std::move(directory))
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(directory_, ec);
+        }
+
+        ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+        ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+        static bool Supported()
+        {
+            if (!glProgramBinary || !glGetProgramBinary)
+                return false;
+
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            return formats > 0;
+        }
+
+        // sources in the order of the shader stages
+        hash_t Key(std::initializer_list<std::string_view> sources)
+        {
+            if (!driver_)
+                driver_ = HashDriver();
+
+            hash_t key = driver_;
+            for (std::string_view source : sources)
+                key = HashCombine(key, HashString(source));
+
+            return key;
+        }
+
+        // links the program from the cached binary
+        bool Load(hash_t key, GLuint program)
+        {
+            if (!Supported())
+                return Miss();
+
+            std::filesystem::path path = Path(key);
+            std::ifstream file{ path, std::ios::binary };
+            if (!file)
+                return Miss();
+
+            file_header header{};
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!file || header.magic != magic || header.key != key)
+                return Discard(key);
+
+            // lengths of truncated or corrupt files are not allocated
+            std::error_code ec;
+            std::uintmax_t size = std::filesystem::file_size(path, ec);
+            if (ec || header.length != size - sizeof(header) ||
+                header.length > (std::uint64_t)std::numeric_limits<GLsizei>::max())
+                return Discard(key);
+
+            std::vector<char> binary(header.length);
+            file.read(binary.data(), (std::streamsize)binary.size());
+            if (!file)
+                return Discard(key);
+
+            glProgramBinary(program, (GLenum)header.format, binary.data(), (GLsizei)binary.size());
+
+            // the driver may reject binaries of other versions
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked)
+                return Discard(key);
+
+            ++hits_;
+            return true;
+        }
+
+        // program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+        bool Store(hash_t key, GLuint program)
+        {
+            if (!Supported())
+                return false;
+
+            GLint length = 0;
+            glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+            if (length <= 0)
+                return false;
+
+            std::vector<char> binary(length);
+            GLenum format = 0;
+            glGetProgramBinary(program, length, &length, &format, binary.data());
+
+            file_header header{ magic, format, key, (std::uint64_t)length };
+
+            std::filesystem::path path = Path(key),
+                tmpPath = path;
+            tmpPath += TempSuffix();
+
+            {
+                std::ofstream file{ tmpPath, std::ios::binary | std::ios::trunc };
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                file.write(binary.data(), length);
+
+                if (!file)
+                {
+                    file.close();
+                    std::error_code ec;
+                    std::filesystem::remove(tmpPath, ec);
+                    return false;
+                }
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(tmpPath, path, ec);
+            if (ec)
+                std::filesystem::remove(tmpPath, ec);
+
+            return !ec;
+        }
+
+        const std::filesystem::path& Directory() const
+        {
+            return directory_;
+        }
+
+        size_t Hits() const
+        {
+            return hits_;
+        }
+
+        size_t Misses() const
+        {
+            return misses_;
+        }
+
+    private:
+
+        static hash_t HashDriver()
+        {
+            hash_t hash = fnv1a_basis;
+            for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+            {
+                const char *str = reinterpret_cast<const char*>(glGetString(name));
+                hash = HashCombine(hash, HashString(str ? str : ""));
+            }
+
+            return hash;
+        }
+
+        std::filesystem::path Path(hash_t key) const
+        {
+            std::ostringstream name;
+            name << std::hex << key << ".bin";
+            return directory_ / name.str();
+        }
+
+        // unique per writer
+        static std::string TempSuffix()
+        {
+            std::ostringstream suffix;
+            suffix << ".tmp" << std::hex << std::random_device()();
+            return suffix.str();
+        }
+
+        bool Miss()
+        {
+            ++misses_;
+            return false;
+        }
+
+        bool Discard(hash_t key)
+        {
+            std::error_code ec;
+            std::filesystem::remove(Path(key), ec);
+            return Miss();
+        }
+    };
+
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+/*
+Separable programs and program pipelines.
+
+StageProgram is a separable program (GL_PROGRAM_SEPARABLE) linked from a single shader
+stage. Pipelines combine stage programs without linking them together, thus N vertex
+and M fragment stages are linked N + M times instead of N * M:
+
+    StageProgram<VertexShader> vProg{ Allocator::Allocate(ProgramTarget()), vShader };
+    StageProgram<FragmentShader> fProg{ Allocator::Allocate(ProgramTarget()), fShader };
+
+    ProgramPipeline<decltype(vProg), decltype(fProg)> pipeline{ vProg, fProg };
+    pipeline.Bind();
+
+Stage interfaces are checked at compile time: input variables of a stage must be output
+by the preceding stage of the pipeline (see VarsIn_* and VarsOut_* of glt_Common.h).
+
+Uniforms of a stage program are set while the program is in use (StageProgram::Use).
+Programs in use override the bound pipeline, thus Bind resets the program in use.
+*/
+
+#include "basic_types.hpp"
+
+#include "shader_traits.hpp"
+#include "uniform_traits.hpp"
+
+#include <tuple>
+#include <type_traits>
+
+namespace glt
+{
+    using HandleProgPipeline = Handle<ProgramPipeLineTarget>;
+
+    // order of the stages in a pipeline
+    constexpr int stage_order(ShaderTarget target)
+    {
+        switch (target)
+        {
+        case ShaderTarget::vertex:
+            return 0;
+        case ShaderTarget::tess_control:
+            return 1;
+        case ShaderTarget::tess_evaluation:
+            return 2;
+        case ShaderTarget::geometry:
+            return 3;
+        case ShaderTarget::fragment:
+            return 4;
+        case ShaderTarget::compute:
+            return 5;
+        default:
+            return -1;
+        }
+    }
+
+    constexpr GLbitfield stage_bit(ShaderTarget target)
+    {
+        switch (target)
+        {
+        case ShaderTarget::vertex:
+            return GL_VERTEX_SHADER_BIT;
+        case ShaderTarget::tess_control:
+            return GL_TESS_CONTROL_SHADER_BIT;
+        case ShaderTarget::tess_evaluation:
+            return GL_TESS_EVALUATION_SHADER_BIT;
+        case ShaderTarget::geometry:
+            return GL_GEOMETRY_SHADER_BIT;
+        case ShaderTarget::fragment:
+            return GL_FRAGMENT_SHADER_BIT;
+        case ShaderTarget::compute:
+            return GL_COMPUTE_SHADER_BIT;
+        default:
+            return 0;
+        }
+    }
+
+    template <class T, class Tuple>
+    struct tuple_contains;
+
+    template <class T, class ... Types>
+    struct tuple_contains<T, std::tuple<Types...>> :
+        std::disjunction<std::is_same<T, Types>...> {};
+
+    // all the variables of Subset are contained in Set
+    template <class Subset, class Set>
+    struct tuple_includes;
+
+    template <class ... Types, class Set>
+    struct tuple_includes<std::tuple<Types...>, Set> :
+        std::conjunction<tuple_contains<Types, Set>...> {};
+
+    template <class Subset, class Set>
+    constexpr inline bool tuple_includes_v = tuple_includes<Subset, Set>();
+
+    template <class shader_t, class unif_collection = uniform_collection<std::tuple<>>>
+    class StageProgram;
+
+    template <ShaderTarget target, class VarsIn, class VarsOut, class ... GLSL>
+    class StageProgram<Shader<target, VarsIn, VarsOut>, uniform_collection<GLSL...>> :
+        public program_base,
+        public uniform_collection<GLSL...>
+    {
+    public:
+
+        using shader = Shader<target, VarsIn, VarsOut>;
+        using uniforms = uniform_collection<GLSL...>;
+        using vars_in = VarsIn;
+        using vars_out = VarsOut;
+
+        constexpr static ShaderTarget stage = target;
+
+        using program_base::operator bool;
+
+        StageProgram(HandleProg&& handle = Allocator::Allocate(ProgramTarget()))
+            : program_base(std::move(handle)),
+            uniforms(static_cast<const program_base&>(*this))
+        {}
+
+        StageProgram(HandleProg&& handle, const shader& stageShader)
+            : StageProgram(std::move(handle))
+        {
+            Link(stageShader);
+        }
+
+        StageProgram(const StageProgram&) = delete;
+        StageProgram& operator=(const StageProgram&) = delete;
+
+        bool Link(const shader& stageShader)
+        {
+            GLuint handle = handle_accessor(program_base::Handle());
+            assert(handle && "StageProgram::Invalid handle!");
+
+            glProgramParameteri(handle, GL_PROGRAM_SEPARABLE, GL_TRUE);
+
+            glAttachShader(handle, handle_accessor(stageShader.GetHandle()));
+            glLinkProgram(handle);
+            glDetachShader(handle, handle_accessor(stageShader.GetHandle()));
+
+            GLint res = false;
+            glGetProgramiv(handle, GL_LINK_STATUS, &res);
+            assert(res && "Failed to link separable program!");
+
+            SetLinkStatus((bool)res);
+            if (res)
+                uniforms::GetLocations();
+            return Linked();
+        }
+    };
+
+    template <class ... Stages>
+    class ProgramPipeline
+    {
+        static_assert(sizeof...(Stages), "Pipeline must have at least one stage!");
+
+        template <size_t i>
+        using stage_i = std::tuple_element_t<i, std::tuple<Stages...>>;
+
+        template <size_t ... indx>
+        constexpr static bool stages_ordered(std::index_sequence<indx...>)
+        {
+            return ((stage_order(stage_i<indx>::stage) < stage_order(stage_i<indx + 1>::stage)) && ...);
+        }
+
+        template <size_t ... indx>
+        constexpr static bool interfaces_match(std::index_sequence<indx...>)
+        {
+            return (tuple_includes_v<typename stage_i<indx + 1>::vars_in,
+                typename stage_i<indx>::vars_out> && ...);
+        }
+
+        static_assert(stages_ordered(std::make_index_sequence<sizeof...(Stages) - 1>()),
+            "Pipeline stages must be unique and specified in the order of the pipeline!");
+        static_assert(interfaces_match(std::make_index_sequence<sizeof...(Stages) - 1>()),
+            "Stage input variables are not output by the preceding stage!");
+
+        HandleProgPipeline handle_;
+
+    public:
+
+        ProgramPipeline(const Stages& ... stages)
+            : ProgramPipeline(Allocator::Allocate(ProgramPipeLineTarget()), stages...)
+        {}
+
+        ProgramPipeline(HandleProgPipeline&& handle, const Stages& ... stages)
+            : handle_(std::move(handle))
+        {
+            assert(handle_ && "ProgramPipeline::Invalid handle!");
+            (UseStage(stages), ...);
+        }
+
+        ProgramPipeline(const ProgramPipeline&) = delete;
+        ProgramPipeline& operator=(const ProgramPipeline&) = delete;
+
+        ProgramPipeline(ProgramPipeline&&) = default;
+        ProgramPipeline& operator=(ProgramPipeline&&) = default;
+
+        // replaces the program of the stage with another one of the same interface
+        template <class Stage>
+        void UseStage(const Stage& stage)
+        {
+            static_assert(std::disjunction_v<std::is_same<Stage, Stages>...>,
+                "Stage program type is not a part of the pipeline!");
+            assert(stage.Linked() && "Stage program is not linked!");
+
+            glUseProgramStages(handle_accessor(handle_), stage_bit(Stage::stage),
+                handle_accessor(stage.Handle()));
+        }
+
+        void Bind()
+        {
+            gl_state& state = gl_state::Current();
+            state.UseProgram(0);
+            state.BindProgramPipeline(handle_accessor(handle_));
+        }
+
+        void UnBind()
+        {
+            assert(IsBound() && "Attempt to unbind pipeline that is not bound!");
+            gl_state::Current().BindProgramPipeline(0);
+        }
+
+        bool IsBound() const
+        {
+            return gl_state::Current().ProgramPipeline() == handle_accessor(handle_);
+        }
+
+        // validates the pipeline against the current OpenGL state
+        bool Validate() const
+        {
+            glValidateProgramPipeline(handle_accessor(handle_));
+
+            GLint res = false;
+            glGetProgramPipelineiv(handle_accessor(handle_), GL_VALIDATE_STATUS, &res);
+            return (bool)res;
+        }
+
+        const HandleProgPipeline& Handle() const
+        {
+            return handle_;
+        }
+    };
+
+}
@@ -2,6 +2,7 @@
 
 #include "basic_types.hpp"
 
+#include "program_cache.hpp"
 #include "shader_traits.hpp"
 #include "uniform_traits.hpp"
 #include "vao_traits.hpp"
@@ -48,6 +49,9 @@ namespace glt
 
 		void Use()
 		{
+            if (linkPending_)
+                Wait();
+
 			program_base::Use();
 		}
 
@@ -61,17 +65,98 @@ namespace glt
 		bool Link(const VertexShader& vShader, const FragmentShader& fShader,
 			const Shader<targets>& ... otherShaders)
 		{
+			linkPending_ = false;
 			SetLinkStatus(Link_(vShader, fShader, otherShaders...));
             GetLocations();
            // assert(uniforms::AllValid() && "Failed to get uniforms locations!");
 			return Linked();
 		}
 
+		// loads the program binary from the cache, compiles and links the sources
+		// on a miss and stores the binary
+		bool Link(ProgramBinaryCache& cache, const std::string& vSource, const std::string& fSource)
+		{
+			GLuint handle = handle_accessor(program_base::Handle());
+			hash_t key = cache.Key({ vSource, fSource });
+
+			if (cache.Load(key, handle))
+			{
+				SetLinkStatus(true);
+				GetLocations();
+				return true;
+			}
+
+			VertexShader vShader{ vSource };
+			FragmentShader fShader{ fSource };
+
+			bool supported = ProgramBinaryCache::Supported();
+			if (supported)
+				glProgramParameteri(handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+			if (Link(vShader, fShader) && supported)
+				cache.Store(key, handle);
+
+			return Linked();
+		}
+
+		// the status is queried by Wait, poll IsReady to avoid blocking.
+		// Shaders may still be compiling
+		template <ShaderTarget ... targets>
+		void LinkAsync(const VertexShader& vShader, const FragmentShader& fShader,
+			const Shader<targets>& ... otherShaders)
+		{
+			Submit_(vShader, fShader, otherShaders...);
+			SetLinkStatus(false);
+			linkPending_ = true;
+		}
+
+		bool IsReady() const
+		{
+			return !linkPending_ || shader_traits::LinkCompleted(program_base::Handle());
+		}
+
+		// blocks until the asynchronous link has completed
+		bool Wait()
+		{
+			if (!linkPending_)
+				return Linked();
+
+			linkPending_ = false;
+			SetLinkStatus(LinkStatus_());
+			assert(Linked() && "Failed to link program!");
+
+			if (Linked())
+				GetLocations();
+			return Linked();
+		}
+
 	private:
 
+		bool linkPending_ = false;
+
 		template <ShaderTarget ... targets>
 		bool Link_(const VertexShader& vShader, const FragmentShader& fShader,
 			const Shader<targets>& ... otherShaders)
+		{
+			Submit_(vShader, fShader, otherShaders...);
+
+			bool res = LinkStatus_();
+			assert(res && "Failed to link program!");
+
+			return res;
+		}
+
+		bool LinkStatus_() const
+		{
+			GLint res = false;
+			glGetProgramiv(handle_accessor(program_base::Handle()), GL_LINK_STATUS, &res);
+			return (bool)res;
+		}
+
+		// attaches the shaders and links without querying the result
+		template <ShaderTarget ... targets>
+		void Submit_(const VertexShader& vShader, const FragmentShader& fShader,
+			const Shader<targets>& ... otherShaders)
 		{
 			assert(program_base::Handle() && "Program::Invalid handle!");
 
@@ -86,12 +171,6 @@ namespace glt
 					handle_accessor(otherShaders.GetHandle())), ...);
 
 			glLinkProgram(handle_accessor(program_base::Handle()));
-
-			GLint res = false;
-			glGetProgramiv(handle_accessor(program_base::Handle()), GL_LINK_STATUS, &res);
-			assert(res && "Failed to link program!");
-
-			return (bool)res;
 		}
 
     public:
@@ -145,7 +224,7 @@ namespace glt
 				DrawTriangleFan(reinterpret_cast<const Program::vao&>(vao), first, count);
 			}
 			
-            // TODO: add VAO as parameter to ensure that it is active during the drawing call
+            // element buffer is left bound, it is a part of the state of the bound VAO
             void DrawElements(glt::Buffer<unsigned int>& elemBuffer, RenderMode mode, size_t count, size_t indexStart = 0)
             {
                 assert(prog_->IsActive() && "Program is not active during Guard's lifetime!");
@@ -154,10 +233,27 @@ namespace glt
                 if (!elemBuffer.IsBound())
                     elemBuffer.Bind(BufferTarget::element_array);
 
-                glDrawElements((GLenum)mode, (GLsizei)count, GL_UNSIGNED_INT, (void*)indexStart);
+                glDrawElements((GLenum)mode, (GLsizei)count, GL_UNSIGNED_INT, (void*)(indexStart * sizeof(GLuint)));
 				assert(AssertGL());
+            }
+
+            // indices of the element buffer recorded in the VAO (see VAO::BindElementBuffer)
+            void DrawElements(const Program::vao& vao, RenderMode mode, size_t count, size_t indexStart = 0)
+            {
+                assert(prog_->IsActive() && "Program is not active during Guard's lifetime!");
+                assert(vao.IsBound() && "VAO is not bound!");
+                assert(vao.ElementBuffer() && vao.ElementBuffer() != gl_state::unknown &&
+                    "VAO has no element buffer recorded!");
+                assert(vao.ElementCount() >= indexStart + count && "Element indices are out of range!");
 
-				elemBuffer.UnBind();
+                glDrawElements((GLenum)mode, (GLsizei)count, GL_UNSIGNED_INT, (void*)(indexStart * sizeof(GLuint)));
+                assert(AssertGL());
+            }
+
+            template <typename ... attr, class = std::enable_if_t<std::conjunction_v<is_equivalent<Attr, attr>...>>>
+            void DrawElements(const VAO<attr...>& vao, RenderMode mode, size_t count, size_t indexStart = 0)
+            {
+                DrawElements(reinterpret_cast<const Program::vao&>(vao), mode, count, indexStart);
             }
 
 
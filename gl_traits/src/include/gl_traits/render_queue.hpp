@@ -0,0 +1,215 @@
+#pragma once
+
+/*
+Queue of draws sorted to minimize state changes.
+
+Draws are submitted as compact commands (program, VAO, textures, uniform block ranges,
+vertex or element range) together with 64-bit sort keys:
+
+    | program 16 | VAO 16 | texture 16 | depth 16 |
+
+Keys are radix sorted before execution, thus draws sharing a program, VAO and texture
+are executed together, front to back. Keys keep only the low 16 bits of the names,
+colliding names only make the grouping less efficient.
+
+Execution binds the state through gl_state, which skips the bindings that have not
+changed between consecutive draws.
+*/
+
+#include "basic_types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace glt
+{
+    struct DrawCommand
+    {
+        constexpr static size_t max_textures = 4;
+        constexpr static size_t max_blocks = 2;
+
+        struct texture_binding
+        {
+            GLuint unit;
+            TextureTarget target;
+            GLuint texture;
+        };
+
+        struct block_binding
+        {
+            GLuint index;
+            GLuint buffer;
+            GLintptr offset;
+            GLsizeiptr size;
+        };
+
+        GLuint program = 0,
+            vao = 0,
+            elementBuffer = 0; // 0 - glDrawArrays
+
+        RenderMode mode = RenderMode::triangles;
+
+        // vertices or indices (GL_UNSIGNED_INT)
+        GLint first = 0;
+        GLsizei count = 0;
+
+        std::array<texture_binding, max_textures> textures{};
+        std::array<block_binding, max_blocks> blocks{};
+        unsigned char textureCount = 0,
+            blockCount = 0;
+
+        DrawCommand& Texture(GLuint unit, TextureTarget target, GLuint texture)
+        {
+            assert(textureCount < max_textures && "Too many textures for a draw!");
+            textures[textureCount++] = texture_binding{ unit, target, texture };
+            return *this;
+        }
+
+        DrawCommand& UniformBlock(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+        {
+            assert(blockCount < max_blocks && "Too many uniform blocks for a draw!");
+            blocks[blockCount++] = block_binding{ index, buffer, offset, size };
+            return *this;
+        }
+    };
+
+    class RenderQueue
+    {
+        using sort_key = std::uint64_t;
+
+        struct entry
+        {
+            sort_key key;
+            std::uint32_t draw;
+        };
+
+        std::vector<DrawCommand> draws_;
+        std::vector<entry> entries_,
+            scratch_;
+
+        bool sorted_ = true;
+
+    public:
+
+        RenderQueue() = default;
+
+        // depth - normalized [0, 1], lower depths are drawn first
+        static sort_key MakeKey(GLuint program, GLuint vao, GLuint texture, float depth)
+        {
+            depth = depth < 0.f ? 0.f : (depth > 1.f ? 1.f : depth);
+
+            return (sort_key)(program & 0xFFFF) << 48 |
+                (sort_key)(vao & 0xFFFF) << 32 |
+                (sort_key)(texture & 0xFFFF) << 16 |
+                (sort_key)(depth * 0xFFFF);
+        }
+
+        void Submit(const DrawCommand& draw, float depth = 0.f)
+        {
+            GLuint texture = draw.textureCount ? draw.textures[0].texture : 0;
+            Submit(MakeKey(draw.program, draw.vao, texture, depth), draw);
+        }
+
+        void Submit(sort_key key, const DrawCommand& draw)
+        {
+            assert(draw.program && draw.vao && "Invalid draw!");
+
+            entries_.push_back(entry{ key, (std::uint32_t)draws_.size() });
+            draws_.push_back(draw);
+            sorted_ = false;
+        }
+
+        // stable LSD radix sort by bytes, skips bytes equal for all the keys
+        void Sort()
+        {
+            if (sorted_)
+                return;
+
+            scratch_.resize(entries_.size());
+
+            for (size_t shift = 0; shift != 64; shift += 8)
+            {
+                std::array<size_t, 256> offsets{};
+                for (const entry& e : entries_)
+                    ++offsets[(e.key >> shift) & 0xFF];
+
+                if (offsets[(entries_.front().key >> shift) & 0xFF] == entries_.size())
+                    continue;
+
+                size_t offset = 0;
+                for (size_t& o : offsets)
+                {
+                    size_t count = o;
+                    o = offset;
+                    offset += count;
+                }
+
+                for (const entry& e : entries_)
+                    scratch_[offsets[(e.key >> shift) & 0xFF]++] = e;
+
+                entries_.swap(scratch_);
+            }
+
+            sorted_ = true;
+        }
+
+        // sorts and issues the draws
+        void Execute()
+        {
+            Sort();
+
+            gl_state& state = gl_state::Current();
+            for (const entry& e : entries_)
+            {
+                const DrawCommand& draw = draws_[e.draw];
+
+                state.UseProgram(draw.program);
+                state.BindVertexArray(draw.vao);
+
+                for (size_t i = 0; i != draw.textureCount; ++i)
+                    state.BindTexture(draw.textures[i].unit, draw.textures[i].target,
+                        draw.textures[i].texture);
+
+                for (size_t i = 0; i != draw.blockCount; ++i)
+                    state.BindBufferRange(BufferTarget::uniform, draw.blocks[i].index,
+                        draw.blocks[i].buffer, draw.blocks[i].offset, draw.blocks[i].size);
+
+                if (draw.elementBuffer)
+                {
+                    // element array binding is a part of VAO state
+                    state.BindBuffer(BufferTarget::element_array, draw.elementBuffer);
+                    glDrawElements((GLenum)draw.mode, draw.count, GL_UNSIGNED_INT,
+                        (const void*)(draw.first * sizeof(GLuint)));
+                }
+                else
+                    glDrawArrays((GLenum)draw.mode, draw.first, draw.count);
+            }
+        }
+
+        void Clear()
+        {
+            draws_.clear();
+            entries_.clear();
+            sorted_ = true;
+        }
+
+        size_t Size() const
+        {
+            return draws_.size();
+        }
+
+        // draws in the order of execution, valid after Sort
+        const DrawCommand& operator[](size_t i) const
+        {
+            assert(sorted_ && "Render queue is not sorted!");
+            return draws_[entries_[i].draw];
+        }
+
+        sort_key Key(size_t i) const
+        {
+            return entries_[i].key;
+        }
+    };
+
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+/*
+Queue of OpenGL objects which deletion is deferred.
+
+Handles destroyed while deferred deletion is enabled (see Context::EnableDeferredDeletion)
+are not deleted immediately, but retired to the queue. Retire may be called from any
+thread and does not call OpenGL.
+
+At the end of a frame, objects retired during the frame are tagged with a fence.
+Objects are deleted in batches once the fence of their frame has signalled, thus
+deleting does not wait for the GPU to finish using them.
+Deleting, fencing and collecting must be done on the thread the owning context is
+current on.
+*/
+
+#include "gl_state.hpp"
+#include "handle_pool.hpp"
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace glt
+{
+    // index of a type within a tuple
+    template <typename T, class Tuple>
+    struct tuple_type_index;
+
+    template <typename T, typename ... Types>
+    struct tuple_type_index<T, std::tuple<T, Types...>> :
+        std::integral_constant<size_t, 0> {};
+
+    template <typename T, typename U, typename ... Types>
+    struct tuple_type_index<T, std::tuple<U, Types...>> :
+        std::integral_constant<size_t, 1 + tuple_type_index<T, std::tuple<Types...>>::value> {};
+
+    template <typename T, class Tuple>
+    constexpr inline size_t tuple_type_index_v = tuple_type_index<T, Tuple>::value;
+
+    class RetireQueue
+    {
+        constexpr static size_t type_count = std::tuple_size_v<TargetTypes>;
+
+        // names of retired objects by the type of objects
+        using retired_names = std::array<std::vector<GLuint>, type_count>;
+
+        struct frame
+        {
+            GLsync fence;
+            retired_names names;
+        };
+
+        std::mutex mutex_;
+        retired_names pending_;
+
+        // fenced frames, accessed only by the owning thread
+        std::deque<frame> frames_;
+
+    public:
+
+        RetireQueue() = default;
+
+        RetireQueue(const RetireQueue&) = delete;
+        RetireQueue& operator=(const RetireQueue&) = delete;
+
+        // context must be current, objects are deleted without waiting
+        ~RetireQueue()
+        {
+            for (frame& f : frames_)
+            {
+                glDeleteSync(f.fence);
+                Delete(f.names, nullptr);
+            }
+
+            Delete(pending_, nullptr);
+        }
+
+        // may be called from any thread
+        template <typename eTargetType>
+        void Retire(GLuint name)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_[tuple_type_index_v<eTargetType, TargetTypes>].push_back(name);
+        }
+
+        // fences objects retired since the previous frame and deletes the ones
+        // which fences have signalled
+        void EndFrame(gl_state& state)
+        {
+            retired_names names;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::swap(names, pending_);
+            }
+
+            bool empty = true;
+            for (const std::vector<GLuint>& typeNames : names)
+                empty = empty && typeNames.empty();
+
+            if (!empty)
+                frames_.push_back(frame{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), std::move(names) });
+
+            Collect(state, false);
+        }
+
+        // deletes objects which fences have signalled, or all the fenced objects if wait is set
+        void Collect(gl_state& state, bool wait)
+        {
+            while (!frames_.empty())
+            {
+                frame& f = frames_.front();
+
+                GLenum res = glClientWaitSync(f.fence, 0, 0);
+                if (wait)
+                    while (res == GL_TIMEOUT_EXPIRED)
+                        res = glClientWaitSync(f.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+                if (res == GL_TIMEOUT_EXPIRED)
+                    break;
+
+                assert(res != GL_WAIT_FAILED && "Failed to wait for retire fence!");
+
+                glDeleteSync(f.fence);
+                Delete(f.names, &state);
+                frames_.pop_front();
+            }
+        }
+
+        // fences and deletes all the retired objects
+        void Flush(gl_state& state)
+        {
+            EndFrame(state);
+            Collect(state, true);
+        }
+
+        // frames which objects have not been deleted yet
+        size_t PendingFrames() const
+        {
+            return frames_.size();
+        }
+
+    private:
+
+        static void Delete(retired_names& names, gl_state *state)
+        {
+            Delete(names, state, std::make_index_sequence<type_count>());
+        }
+
+        template <size_t ... indx>
+        static void Delete(retired_names& names, gl_state *state, std::index_sequence<indx...>)
+        {
+            (DeleteNames<std::tuple_element_t<indx, TargetTypes>>(names[indx], state), ...);
+        }
+
+        template <typename eTargetType>
+        static void DeleteNames(std::vector<GLuint>& names, gl_state *state)
+        {
+            if (names.empty())
+                return;
+
+            if (state)
+                for (GLuint name : names)
+                    state->Forget<eTargetType>(name);
+
+            constexpr auto ppDeleteFunc = pp_gl_deleter_v<eTargetType>;
+
+            if constexpr (is_poolable_v<eTargetType>)
+                (*ppDeleteFunc)((GLsizei)names.size(), names.data());
+            else
+                for (GLuint name : names)
+                    (*ppDeleteFunc)(name);
+
+            names.clear();
+        }
+    };
+
+}
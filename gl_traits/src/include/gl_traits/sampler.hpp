@@ -0,0 +1,245 @@
+#pragma once
+
+/*
+Sampler objects (OpenGL 3.3) and a cache of samplers shared by textures.
+
+A sampler bound to a texture unit overrides the sampling parameters of the texture bound
+to the unit, thus textures carry no sampling state and any number of textures sample with
+a few sampler objects. The cache creates a sampler per distinct state:
+
+    SamplerCache samplers;
+
+    SamplerState trilinear;
+    trilinear.minFilter = TexFilter::linear_mipmap_linear;
+
+    texture.Bind(0);
+    samplers.Bind(0, trilinear);
+
+Must be used on the thread the context is current on.
+*/
+
+#include "basic_types.hpp"
+#include "gltHash.hpp"
+
+#include <array>
+#include <deque>
+#include <unordered_map>
+
+// core in OpenGL 4.6, EXT_texture_filter_anisotropic otherwise
+#ifndef GL_TEXTURE_MAX_ANISOTROPY
+#define GL_TEXTURE_MAX_ANISOTROPY 0x84FE
+#endif
+
+namespace glt
+{
+    // defaults are those of OpenGL
+    struct SamplerState
+    {
+        TexFilter minFilter = TexFilter::nearest_mipmap_linear,
+            magFilter = TexFilter::linear;
+
+        TexWrap wrapS = TexWrap::repeat,
+            wrapT = TexWrap::repeat,
+            wrapR = TexWrap::repeat;
+
+        float minLod = -1000.f,
+            maxLod = 1000.f,
+            lodBias = 0.f;
+
+        // 1 - disabled, other values require OpenGL 4.6 or EXT_texture_filter_anisotropic
+        float maxAnisotropy = 1.f;
+
+        std::array<float, 4> borderColor{};
+
+        // depth comparison of shadow samplers
+        bool compare = false;
+        CompareFunc compareFunc = CompareFunc::lequal;
+
+        bool operator==(const SamplerState& other) const
+        {
+            return minFilter == other.minFilter && magFilter == other.magFilter &&
+                wrapS == other.wrapS && wrapT == other.wrapT && wrapR == other.wrapR &&
+                minLod == other.minLod && maxLod == other.maxLod && lodBias == other.lodBias &&
+                maxAnisotropy == other.maxAnisotropy && borderColor == other.borderColor &&
+                compare == other.compare && compareFunc == other.compareFunc;
+        }
+
+        bool operator!=(const SamplerState& other) const
+        {
+            return !operator==(other);
+        }
+    };
+
+    // members are hashed separately, padding is not
+    inline hash_t HashSamplerState(const SamplerState& state)
+    {
+        hash_t hash = fnv1a_basis;
+
+        GLint enums[]{ (GLint)state.minFilter, (GLint)state.magFilter,
+            (GLint)state.wrapS, (GLint)state.wrapT, (GLint)state.wrapR,
+            (GLint)state.compare, (GLint)state.compareFunc };
+        hash = HashBytes(enums, sizeof(enums), hash);
+
+        float floats[]{ state.minLod, state.maxLod, state.lodBias, state.maxAnisotropy };
+        hash = HashBytes(floats, sizeof(floats), hash);
+
+        return HashBytes(state.borderColor.data(), sizeof(float) * 4, hash);
+    }
+
+    class Sampler
+    {
+        HandleSampler handle_;
+        SamplerState state_;
+
+    public:
+
+        explicit Sampler(const SamplerState& state = SamplerState(),
+            HandleSampler&& handle = Allocator::Allocate(SamplerTarget()))
+            : handle_(std::move(handle))
+        {
+            Apply(state);
+        }
+
+        Sampler(Sampler&&) = default;
+        Sampler& operator=(Sampler&&) = default;
+
+        // sets the parameters differing from the current state
+        void Set(const SamplerState& state)
+        {
+            if (state != state_)
+                Apply(state, false);
+        }
+
+        const SamplerState& State() const
+        {
+            return state_;
+        }
+
+        // textures bound to the unit are sampled with the sampler
+        void Bind(GLuint unit) const
+        {
+            gl_state::Current().BindSampler(unit, handle_accessor(handle_));
+        }
+
+        bool IsBound(GLuint unit) const
+        {
+            return handle_ && gl_state::Current().Sampler(unit) == (GLuint)handle_accessor(handle_);
+        }
+
+        // textures bound to the unit are sampled with their own parameters
+        void UnBind(GLuint unit) const
+        {
+            assert(IsBound(unit) && "Attempt to unbind non-active sampler!");
+            gl_state::Current().BindSampler(unit, 0);
+        }
+
+        const HandleSampler& Handle() const
+        {
+            return handle_;
+        }
+
+    private:
+
+        // all - a new sampler object has the default state
+        void Apply(const SamplerState& state, bool all = true)
+        {
+            GLuint name = handle_accessor(handle_);
+            const SamplerState& cur = state_;
+
+            auto seti = [&](GLenum param, GLint val, GLint curVal)
+            {
+                if (all || val != curVal)
+                    glSamplerParameteri(name, param, val);
+            };
+
+            auto setf = [&](GLenum param, float val, float curVal)
+            {
+                if (all || val != curVal)
+                    glSamplerParameterf(name, param, val);
+            };
+
+            seti(GL_TEXTURE_MIN_FILTER, (GLint)state.minFilter, (GLint)cur.minFilter);
+            seti(GL_TEXTURE_MAG_FILTER, (GLint)state.magFilter, (GLint)cur.magFilter);
+            seti(GL_TEXTURE_WRAP_S, (GLint)state.wrapS, (GLint)cur.wrapS);
+            seti(GL_TEXTURE_WRAP_T, (GLint)state.wrapT, (GLint)cur.wrapT);
+            seti(GL_TEXTURE_WRAP_R, (GLint)state.wrapR, (GLint)cur.wrapR);
+
+            setf(GL_TEXTURE_MIN_LOD, state.minLod, cur.minLod);
+            setf(GL_TEXTURE_MAX_LOD, state.maxLod, cur.maxLod);
+            setf(GL_TEXTURE_LOD_BIAS, state.lodBias, cur.lodBias);
+
+            if (all ? state.maxAnisotropy != 1.f : state.maxAnisotropy != cur.maxAnisotropy)
+                glSamplerParameterf(name, GL_TEXTURE_MAX_ANISOTROPY, state.maxAnisotropy);
+
+            if (all ? state.borderColor != SamplerState().borderColor :
+                state.borderColor != cur.borderColor)
+                glSamplerParameterfv(name, GL_TEXTURE_BORDER_COLOR, state.borderColor.data());
+
+            seti(GL_TEXTURE_COMPARE_MODE,
+                state.compare ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE,
+                cur.compare ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE);
+            seti(GL_TEXTURE_COMPARE_FUNC, (GLint)state.compareFunc, (GLint)cur.compareFunc);
+
+            state_ = state;
+        }
+    };
+
+    // samplers are created once per distinct state and are never deleted before the cache
+    class SamplerCache
+    {
+        // references are stable
+        std::deque<Sampler> samplers_;
+        std::unordered_multimap<hash_t, size_t> indices_;
+
+        size_t hits_ = 0,
+            misses_ = 0;
+
+    public:
+
+        SamplerCache() = default;
+
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator=(const SamplerCache&) = delete;
+
+        // cached samplers are not modified, their states key the cache
+        const Sampler& Get(const SamplerState& state)
+        {
+            hash_t key = HashSamplerState(state);
+
+            auto range = indices_.equal_range(key);
+            for (auto it = range.first; it != range.second; ++it)
+                if (samplers_[it->second].State() == state)
+                {
+                    ++hits_;
+                    return samplers_[it->second];
+                }
+
+            ++misses_;
+            samplers_.emplace_back(state);
+            indices_.emplace(key, samplers_.size() - 1);
+            return samplers_.back();
+        }
+
+        void Bind(GLuint unit, const SamplerState& state)
+        {
+            Get(state).Bind(unit);
+        }
+
+        // number of sampler objects
+        size_t Size() const
+        {
+            return samplers_.size();
+        }
+
+        size_t Hits() const
+        {
+            return hits_;
+        }
+
+        size_t Misses() const
+        {
+            return misses_;
+        }
+    };
+
+}
@@ -10,8 +10,16 @@
 
 // TODO: https://www.khronos.org/opengl/wiki/Type_Qualifier_(GLSL)#Shader_stage_inputs_and_outputs 
 
+// KHR_parallel_shader_compile, same value as GL_COMPLETION_STATUS_ARB
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace glt
 {
+	// compile or link without waiting for the result (see Shader::CompileAsync, Program::LinkAsync)
+	struct async_tag {};
+
 	struct shader_traits
 	{
 		//static inline ParseAlgorithm<ShaderFileInfo::text_source> algorithm;
@@ -68,13 +76,54 @@ namespace glt
 		}
 
 		static bool Compile(const HandleShader& handle, const char *source, size_t length)
+		{
+			Submit(handle, source, length);
+            return CompileStatus(handle);
+		}
+
+		// compiles without querying the result
+		static void Submit(const HandleShader& handle, const char *source, size_t length)
 		{
 			assert(handle && "Shader::Invalid shader handle!");
 
 			glShaderSource(handle_accessor(handle), 1, &source, (GLint*)&length);
 			glCompileShader(handle_accessor(handle));
-			
-            return CompileStatus(handle);
+		}
+
+		// completion of compiles and links may be polled without blocking
+		static bool ParallelCompile()
+		{
+			return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+		}
+
+		// number of driver compiler threads, by default - implementation-specific maximum
+		static void SetCompilerThreads(GLuint count = 0xFFFFFFFF)
+		{
+			if (GLAD_GL_KHR_parallel_shader_compile)
+				glMaxShaderCompilerThreadsKHR(count);
+			else if (GLAD_GL_ARB_parallel_shader_compile)
+				glMaxShaderCompilerThreadsARB(count);
+		}
+
+		// always true without parallel compile, querying the status would block
+		static bool CompileCompleted(const HandleShader& handle)
+		{
+			if (!ParallelCompile())
+				return true;
+
+			GLint res = false;
+			glGetShaderiv(handle_accessor(handle), GL_COMPLETION_STATUS_KHR, &res);
+			return (bool)res;
+		}
+
+		static bool LinkCompleted(const HandleProg& handle)
+		{
+			if (!ParallelCompile())
+				return true;
+
+			GLint res = false;
+			glGetProgramiv(handle_accessor(handle), GL_COMPLETION_STATUS_KHR, &res);
+			return (bool)res;
 		}
 
 	};
@@ -86,7 +135,10 @@ namespace glt
 		HandleShader handle_;
 
         // TODO: remove from Shader and store in map of compiled shaders at shader_traits?
-		bool compiled_ = false;
+		mutable bool compiled_ = false;
+
+		// compile status has not been queried yet (see CompileAsync)
+		mutable bool pending_ = false;
 
         static_assert(tuple_unique_names_v<VarsIn>,
             "Shader inut variables have identical aliases!");
@@ -120,6 +172,13 @@ namespace glt
             : Shader(source, length, std::move(handle))
         {}
 
+		Shader(const std::string& source, async_tag,
+			HandleShader&& handle = Allocator::Allocate(target))
+			: handle_(std::move(handle))
+		{
+			CompileAsync(source);
+		}
+
 		
 		// shaders actually may be allowed to be copied, but what about the handle?
 		Shader(const Shader&) = delete;
@@ -147,12 +206,40 @@ namespace glt
             return Compile(source, length);
         }
 
-		constexpr bool IsValid() const noexcept
+		// the status is queried by IsValid, poll IsReady to avoid blocking
+		void CompileAsync(const char *source, size_t length)
 		{
+            assert((shader_traits::check_source<VarsIn, VarsOut>(std::string_view(source))) &&
+                "Invalid shader source file! Variables mismatch!");
+			shader_traits::Submit(handle_, source, length);
+			compiled_ = false;
+			pending_ = true;
+		}
+
+		void CompileAsync(const std::string& source)
+		{
+			CompileAsync(source.c_str(), source.size());
+		}
+
+		bool IsReady() const
+		{
+			return !pending_ || shader_traits::CompileCompleted(handle_);
+		}
+
+		// blocks until the asynchronous compilation has completed
+		bool IsValid() const noexcept
+		{
+			if (pending_)
+			{
+				pending_ = false;
+				compiled_ = shader_traits::CompileStatus(handle_);
+				assert(compiled_ && "Shader::Failed to compile shader!");
+			}
+
 			return compiled_;
 		}
 
-		constexpr operator bool() const noexcept
+		operator bool() const noexcept
 		{
 			return IsValid();
 		}
@@ -0,0 +1,214 @@
+#pragma once
+
+/*
+Shader variants: permutations of a shader source by sets of #define.
+
+Defines are injected after the #version directive. Each permutation is compiled
+once and the compiled Shader is shared by all the programs that request it:
+
+    ShaderVariants<FragmentShader> variants{ source };
+
+    std::shared_ptr<const FragmentShader> shader = variants.Get({ { "USE_NORMAL_MAP", "1" } });
+    program.Link(*vShader, *shader);
+
+Permutations known in advance may be precompiled at startup (see Precompile), their
+compilation is submitted at once without waiting for the results.
+
+Variants belong to the context they have been compiled in and must be used on its thread.
+*/
+
+#include "gltHash.hpp"
+#include "shader_traits.hpp"
+
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace glt
+{
+    class ShaderDefines
+    {
+        // sorted by names, thus the key does not depend on the order of definition
+        std::vector<std::pair<std::string, std::string>> defines_;
+
+    public:
+
+        ShaderDefines() = default;
+
+        ShaderDefines(std::initializer_list<std::pair<std::string, std::string>> defines)
+        {
+            for (const auto& define : defines)
+                Define(define.first, define.second);
+        }
+
+        // redefines existing
+        ShaderDefines& Define(std::string name, std::string value = "1")
+        {
+            auto found = std::lower_bound(defines_.begin(), defines_.end(), name,
+                [](const std::pair<std::string, std::string>& d, const std::string& name)
+            {
+                return d.first < name;
+            });
+
+            if (found != defines_.end() && found->first == name)
+                found->second = std::move(value);
+            else
+                defines_.emplace(found, std::move(name), std::move(value));
+
+            return *this;
+        }
+
+        hash_t Key() const
+        {
+            hash_t key = fnv1a_basis;
+            for (const auto& define : defines_)
+            {
+                key = HashCombine(key, HashString(define.first));
+                key = HashCombine(key, HashString(define.second));
+            }
+
+            return key;
+        }
+
+        size_t Count() const
+        {
+            return defines_.size();
+        }
+
+        bool operator==(const ShaderDefines& other) const
+        {
+            return defines_ == other.defines_;
+        }
+
+        bool operator!=(const ShaderDefines& other) const
+        {
+            return !operator==(other);
+        }
+
+        // source with the defines following #version (if any)
+        std::string Inject(std::string_view source) const
+        {
+            size_t pos = 0;
+
+            size_t version = source.find("#version");
+            if (version != std::string_view::npos)
+            {
+                pos = source.find('\n', version);
+                pos = pos == std::string_view::npos ? source.size() : pos + 1;
+            }
+
+            std::string out{ source.substr(0, pos) };
+            if (pos && out.back() != '\n')
+                out += '\n';
+
+            for (const auto& define : defines_)
+                out.append("#define ").append(define.first).append(" ").append(define.second) += '\n';
+
+            out.append(source.substr(pos));
+            return out;
+        }
+    };
+
+    struct HashShaderDefines
+    {
+        size_t operator()(const ShaderDefines& defines) const
+        {
+            return (size_t)defines.Key();
+        }
+    };
+
+    template <class shader_t>
+    class ShaderVariants;
+
+    template <ShaderTarget target, class VarsIn, class VarsOut>
+    class ShaderVariants<Shader<target, VarsIn, VarsOut>>
+    {
+    public:
+
+        using shader = Shader<target, VarsIn, VarsOut>;
+
+    private:
+
+        std::string source_;
+        hash_t sourceKey_;
+
+        // keyed by the defines, thus colliding keys are different variants
+        std::unordered_map<ShaderDefines, std::shared_ptr<const shader>, HashShaderDefines> variants_;
+        size_t compiles_ = 0;
+
+    public:
+
+        explicit ShaderVariants(std::string source)
+            : source_(std::move(source)),
+            sourceKey_(HashString(source_))
+        {}
+
+        ShaderVariants(const ShaderVariants&) = delete;
+        ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+        // stable across runs, may be used as a key of other caches
+        hash_t Key(const ShaderDefines& defines) const
+        {
+            return HashCombine(sourceKey_, defines.Key());
+        }
+
+        // compiles the permutation if it has not been compiled yet
+        std::shared_ptr<const shader> Get(const ShaderDefines& defines = ShaderDefines())
+        {
+            std::shared_ptr<const shader>& variant = variants_[defines];
+            if (!variant)
+            {
+                variant = std::make_shared<const shader>(defines.Inject(source_));
+                ++compiles_;
+            }
+
+            return variant;
+        }
+
+        // submits compilation of the permutations without waiting for the results
+        void Precompile(const std::vector<ShaderDefines>& permutations)
+        {
+            for (const ShaderDefines& defines : permutations)
+            {
+                std::shared_ptr<const shader>& variant = variants_[defines];
+                if (variant)
+                    continue;
+
+                variant = std::make_shared<const shader>(defines.Inject(source_), async_tag());
+                ++compiles_;
+            }
+        }
+
+        bool Contains(const ShaderDefines& defines) const
+        {
+            return variants_.count(defines);
+        }
+
+        // variants still used by programs are not deleted until released
+        void Clear()
+        {
+            variants_.clear();
+        }
+
+        size_t Count() const
+        {
+            return variants_.size();
+        }
+
+        size_t Compiles() const
+        {
+            return compiles_;
+        }
+
+        const std::string& Source() const
+        {
+            return source_;
+        }
+    };
+
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+/*
+Cache of 2D textures keyed by the hash of their contents, limited by a budget of video memory.
+
+Identical images cached under different names are a single texture when keyed by the hash
+of their pixels (or files). Memory of a texture is estimated from its sizes, levels and
+internal format (see texture_bytes). Exceeding the budget evicts the least recently used
+textures which are not referenced outside of the cache, as deleting them releases memory:
+
+    TextureCache<TexInternFormat::rgba8> cache{ 256 << 20 };
+
+    TextureKey key = TextureCache<TexInternFormat::rgba8>::Key(pixels, bytes);
+    Texture2D<TexInternFormat::rgba8> texture = cache.Get(key, [&]()
+    {
+        Texture2D<TexInternFormat::rgba8> tex;
+        ...
+        return tex;
+    });
+
+Keys hold the size of the contents with their hash, thus colliding hashes of images of
+different sizes are different textures.
+Textures sharing an object share its sizes, thus textures respecified after being cached
+(asynchronous loading, see TextureLoader) are measured again by Trim.
+Must be used on the thread the context is current on.
+*/
+
+#include "Texture.hpp"
+#include "gltHash.hpp"
+
+#include <list>
+#include <optional>
+#include <unordered_map>
+
+namespace glt
+{
+    struct TextureKey
+    {
+        hash_t hash = 0;
+
+        // bytes of the hashed contents
+        size_t size = 0;
+
+        bool operator==(const TextureKey& other) const
+        {
+            return hash == other.hash && size == other.size;
+        }
+
+        bool operator!=(const TextureKey& other) const
+        {
+            return !operator==(other);
+        }
+    };
+
+    struct HashTextureKey
+    {
+        size_t operator()(const TextureKey& key) const
+        {
+            return (size_t)key.hash;
+        }
+    };
+
+    template <TexInternFormat format>
+    class TextureCache
+    {
+    public:
+
+        using texture = Texture2D<format>;
+
+    private:
+
+        struct entry
+        {
+            texture tex;
+            size_t bytes;
+            std::list<TextureKey>::iterator used;
+        };
+
+        // keyed by the hashes and the sizes, thus colliding hashes are compared by sizes
+        std::unordered_map<TextureKey, entry, HashTextureKey> entries_;
+
+        // most recently used first
+        std::list<TextureKey> used_;
+
+        size_t budget_,
+            bytes_ = 0;
+
+        size_t hits_ = 0,
+            misses_ = 0,
+            evictions_ = 0;
+
+    public:
+
+        explicit TextureCache(size_t budgetBytes)
+            : budget_(budgetBytes)
+        {}
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        static TextureKey Key(const void *data, size_t size)
+        {
+            return TextureKey{ HashBytes(data, size), size };
+        }
+
+        // texture sharing the cached one
+        std::optional<texture> Find(const TextureKey& key)
+        {
+            auto found = entries_.find(key);
+            if (found == entries_.end())
+            {
+                ++misses_;
+                return std::nullopt;
+            }
+
+            ++hits_;
+            Touch(found->second);
+            return found->second.tex.Share();
+        }
+
+        // replaces the texture cached with the key, may evict other textures
+        texture Insert(const TextureKey& key, texture tex)
+        {
+            Erase(key);
+
+            used_.push_front(key);
+            size_t bytes = texture_bytes(tex, format);
+            auto emplaced = entries_.emplace(key, entry{ std::move(tex), bytes, used_.begin() });
+            bytes_ += bytes;
+
+            // referenced, thus not evicted
+            texture shared = emplaced.first->second.tex.Share();
+            Evict();
+            return shared;
+        }
+
+        // create - texture Create(), invoked on a miss
+        template <typename Create>
+        texture Get(const TextureKey& key, Create&& create)
+        {
+            std::optional<texture> cached = Find(key);
+            if (cached)
+                return std::move(*cached);
+
+            return Insert(key, create());
+        }
+
+        bool Erase(const TextureKey& key)
+        {
+            auto found = entries_.find(key);
+            if (found == entries_.end())
+                return false;
+
+            bytes_ -= found->second.bytes;
+            used_.erase(found->second.used);
+            entries_.erase(found);
+            return true;
+        }
+
+        void Clear()
+        {
+            entries_.clear();
+            used_.clear();
+            bytes_ = 0;
+        }
+
+        // measures the textures again and evicts the exceeding ones
+        void Trim()
+        {
+            bytes_ = 0;
+            for (auto& e : entries_)
+            {
+                e.second.bytes = texture_bytes(e.second.tex, format);
+                bytes_ += e.second.bytes;
+            }
+
+            Evict();
+        }
+
+        void SetBudget(size_t budgetBytes)
+        {
+            budget_ = budgetBytes;
+            Evict();
+        }
+
+        size_t Budget() const
+        {
+            return budget_;
+        }
+
+        // estimated video memory of the cached textures
+        size_t Bytes() const
+        {
+            return bytes_;
+        }
+
+        size_t Size() const
+        {
+            return entries_.size();
+        }
+
+        size_t Hits() const
+        {
+            return hits_;
+        }
+
+        size_t Misses() const
+        {
+            return misses_;
+        }
+
+        size_t Evictions() const
+        {
+            return evictions_;
+        }
+
+    private:
+
+        void Touch(entry& e)
+        {
+            used_.splice(used_.begin(), used_, e.used);
+        }
+
+        // textures in use are kept, the cache may exceed the budget
+        void Evict()
+        {
+            for (auto it = used_.end(); bytes_ > budget_ && it != used_.begin();)
+            {
+                --it;
+
+                auto found = entries_.find(*it);
+                if (found->second.tex.UseCount() > 1)
+                    continue;
+
+                bytes_ -= found->second.bytes;
+                entries_.erase(found);
+                it = used_.erase(it);
+                ++evictions_;
+            }
+        }
+    };
+
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+/*
+Asynchronous loader of 2D textures.
+
+Images are decoded by a pool of worker threads with a user provided decoder (files,
+archives, etc). Load returns at once a texture holding a 1x1 placeholder, the decoded
+image replaces it later in the same OpenGL texture, thus all the objects sharing the
+texture (see Texture::Share) get the image and its sizes:
+
+    TextureLoader<TexInternFormat::rgba> loader{ [](const std::string& path)
+    {
+        Image im{ path };
+        ...
+        return decoded;
+    } };
+
+    Texture2Drgba texture = loader.Load("diffuse.png");
+
+    // every frame, on the thread the context is current on
+    loader.Upload(8 << 20);
+
+Decoders are invoked on the worker threads and must not call OpenGL. Mip chains computed
+by decoders are uploaded instead of generating them with OpenGL.
+Upload is limited by a budget of bytes per call, thus loading many images does not
+stall a single frame. Load and Upload must be called on the thread the context is
+current on.
+*/
+
+#include "Texture.hpp"
+#include "pixel_upload.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace glt
+{
+    struct DecodedImage
+    {
+        unsigned int width = 0,
+            height = 0;
+
+        TexFormat format = TexFormat::rgba;
+        TexType type = TexType::unsigned_byte;
+
+        // rows are tightly packed, empty - failed to decode, the placeholder is kept
+        std::vector<unsigned char> pixels;
+
+        // levels from 1 computed by the decoder, empty - generated by OpenGL
+        std::vector<std::vector<unsigned char>> mips;
+    };
+
+    template <TexInternFormat internalFormat>
+    class TextureLoader
+    {
+    public:
+
+        using texture = Texture2D<internalFormat>;
+        using decoder = std::function<DecodedImage(const std::string&)>;
+
+    private:
+
+        struct request
+        {
+            size_t id;
+            std::string source;
+        };
+
+        struct decoded
+        {
+            size_t id;
+            DecodedImage image;
+        };
+
+        decoder decode_;
+        std::array<unsigned char, 4> placeholder_;
+
+        // accessed by the workers
+        std::deque<request> requests_;
+        std::deque<decoded> decoded_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stop_ = false;
+
+        // textures waiting for their images, accessed by the context thread
+        std::unordered_map<size_t, texture> waiting_;
+        size_t nextId_ = 0,
+            failed_ = 0;
+
+        std::vector<std::thread> workers_;
+
+    public:
+
+        // placeholder - rgba color of the textures until their images are uploaded
+        explicit TextureLoader(decoder decode, size_t threads = 0,
+            std::array<unsigned char, 4> placeholder = { 128, 128, 128, 255 })
+            : decode_(std::move(decode)),
+            placeholder_(placeholder)
+        {
+            assert(decode_ && "Invalid decoder!");
+
+            if (!threads)
+            {
+                // the context thread is left a core
+                unsigned int cores = std::thread::hardware_concurrency();
+                threads = cores > 1 ? cores - 1 : 1;
+            }
+
+            for (size_t i = 0; i != threads; ++i)
+                workers_.emplace_back(&TextureLoader::Run, this);
+        }
+
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+        // requests not decoded yet are dropped
+        ~TextureLoader()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+
+            cv_.notify_all();
+            for (std::thread& worker : workers_)
+                worker.join();
+        }
+
+        // texture sharing the one that receives the image
+        texture Load(std::string source)
+        {
+            texture tex;
+            tex.Bind();
+            tex.SetImage(0, 1, 1);
+            tex.SubImage(0, 1, 1, TexFormat::rgba, TexType::unsigned_byte, placeholder_.data());
+            tex.UnBind();
+
+            texture shared = tex.Share();
+
+            size_t id = nextId_++;
+            waiting_.emplace(id, std::move(tex));
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                requests_.push_back(request{ id, std::move(source) });
+            }
+
+            cv_.notify_one();
+            return shared;
+        }
+
+        /*
+        Uploads decoded images until the budget is exceeded, at least one image is uploaded.
+        Pixels may be staged in a pixel_unpack ring, thus the upload does not copy them.
+        Returns the number of uploaded images.
+        */
+        size_t Upload(size_t budgetBytes, PixelUploadRing *ring = nullptr)
+        {
+            size_t uploaded = 0,
+                bytes = 0;
+
+            while (bytes < budgetBytes || !uploaded)
+            {
+                decoded d;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (decoded_.empty())
+                        break;
+
+                    d = std::move(decoded_.front());
+                    decoded_.pop_front();
+                }
+
+                auto found = waiting_.find(d.id);
+                assert(found != waiting_.end() && "Decoded image has no texture!");
+
+                if (d.image.pixels.empty())
+                    ++failed_;
+                else
+                    Upload(found->second, d.image, ring);
+
+                bytes += d.image.pixels.size();
+                for (const std::vector<unsigned char>& mip : d.image.mips)
+                    bytes += mip.size();
+                waiting_.erase(found);
+                ++uploaded;
+            }
+
+            return uploaded;
+        }
+
+        // textures still holding the placeholder
+        size_t Pending() const
+        {
+            return waiting_.size();
+        }
+
+        size_t Failed() const
+        {
+            return failed_;
+        }
+
+    private:
+
+        static void Upload(texture& tex, const DecodedImage& image, PixelUploadRing *ring)
+        {
+            tex.Bind();
+
+            if (!image.mips.empty())
+            {
+                std::vector<const void*> levels{ image.pixels.data() };
+                for (const std::vector<unsigned char>& mip : image.mips)
+                    levels.push_back(mip.data());
+
+                tex.SetMipChain((unsigned int)levels.size(), image.width, image.height,
+                    image.format, image.type, levels.data());
+                tex.UnBind();
+                return;
+            }
+
+            tex.SetImage(0, image.width, image.height);
+
+            GLint alignment = 4;
+            glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            if (ring && image.pixels.size() <= ring->Size())
+            {
+                ring->Bind();
+                tex.SubImage(0, image.width, image.height, image.format, image.type,
+                    ring->Write(image.pixels.data(), image.pixels.size()));
+                ring->Fence();
+                ring->UnBind();
+            }
+            else
+                tex.SubImage(0, image.width, image.height, image.format, image.type,
+                    image.pixels.data());
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+            tex.GenerateMipMap();
+            tex.UnBind();
+        }
+
+        void Run()
+        {
+            for (;;)
+            {
+                request r;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    cv_.wait(lock, [this]() { return stop_ || !requests_.empty(); });
+
+                    if (stop_)
+                        return;
+
+                    r = std::move(requests_.front());
+                    requests_.pop_front();
+                }
+
+                DecodedImage image = decode_(r.source);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                decoded_.push_back(decoded{ r.id, std::move(image) });
+            }
+        }
+    };
+
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+/*
+Packer of textures of the same size into layers of 2D texture arrays.
+
+Images are added with their pixels and refer to a (texture array, layer) pair.
+Build creates the arrays, thus textures of all the materials sharing a size are
+bound once and sampled by layer:
+
+    TextureArrayPacker<TexInternFormat::rgba8> packer;
+    TextureLayer diffuse = packer.Add(width, height, TexFormat::rgba, TexType::unsigned_byte,
+        std::move(pixels));
+
+    std::vector<Texture2DArray<TexInternFormat::rgba8>> arrays = packer.Build();
+    arrays[diffuse.array].Bind();
+
+Pixels are tightly packed (unpack alignment of 1).
+Layers of an array are limited (GL_MAX_ARRAY_TEXTURE_LAYERS, at least 256 in OpenGL 3.3),
+images of the same size exceeding the limit are packed to another array.
+*/
+
+#include "Texture.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace glt
+{
+    struct TextureLayer
+    {
+        size_t array;
+        GLint layer;
+    };
+
+    template <TexInternFormat format>
+    class TextureArrayPacker
+    {
+        static_assert(is_sized_format(format) && !is_compressed_format(format),
+            "Texture arrays are allocated with immutable storage of uncompressed format!");
+
+        struct image
+        {
+            TexFormat pixelFormat;
+            TexType type;
+            std::vector<unsigned char> pixels;
+        };
+
+        struct group
+        {
+            unsigned int width,
+                height;
+            std::vector<image> layers;
+        };
+
+        std::vector<group> groups_;
+        size_t maxLayers_;
+
+    public:
+
+        using texture_array = Texture2DArray<format>;
+
+        explicit TextureArrayPacker(size_t maxLayers = 256)
+            : maxLayers_(maxLayers)
+        {
+            assert(maxLayers_ && "Invalid number of layers!");
+        }
+
+        // pixels are kept until Build
+        TextureLayer Add(unsigned int width, unsigned int height,
+            TexFormat pixelFormat, TexType type, std::vector<unsigned char> pixels)
+        {
+            assert(width && height && "Invalid image!");
+            assert(pixels.size() == (size_t)width * height * pixel_bytes(pixelFormat, type) &&
+                "Pixels do not match the size of the image!");
+
+            size_t indx = 0;
+            for (; indx != groups_.size(); ++indx)
+                if (groups_[indx].width == width && groups_[indx].height == height &&
+                    groups_[indx].layers.size() < maxLayers_)
+                    break;
+
+            if (indx == groups_.size())
+                groups_.push_back(group{ width, height, {} });
+
+            std::vector<image>& layers = groups_[indx].layers;
+            layers.push_back(image{ pixelFormat, type, std::move(pixels) });
+
+            return TextureLayer{ indx, (GLint)layers.size() - 1 };
+        }
+
+        size_t Arrays() const
+        {
+            return groups_.size();
+        }
+
+        size_t Layers(size_t array) const
+        {
+            return groups_[array].layers.size();
+        }
+
+        // creates the arrays referred by the added layers and releases the pixels
+        std::vector<texture_array> Build(bool mipmaps = true)
+        {
+            std::vector<texture_array> arrays;
+            arrays.reserve(groups_.size());
+
+            // rows of 1 and 3-component layers are not multiples of 4 bytes
+            GLint alignment = 4;
+            glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            for (group& g : groups_)
+            {
+                texture_array arr;
+                arr.Bind();
+                arr.SetStorage(mipmaps ? 0 : 1, g.width, g.height, (unsigned int)g.layers.size());
+
+                for (size_t i = 0; i != g.layers.size(); ++i)
+                    arr.SubImage(0, g.width, g.height, 1, g.layers[i].pixelFormat, g.layers[i].type,
+                        g.layers[i].pixels.data(), 0, 0, (int)i);
+
+                if (mipmaps)
+                    arr.GenerateMipMap();
+
+                arr.UnBind();
+                arrays.push_back(std::move(arr));
+            }
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+            groups_.clear();
+            return arrays;
+        }
+    };
+
+}
@@ -2,8 +2,230 @@
 
 #include "basic_types.hpp"
 
+#include <algorithm>
+#include <array>
+
 namespace glt
 {
+	// number of levels of a full mip chain
+	constexpr unsigned int mip_levels(unsigned int width, unsigned int height = 1,
+		unsigned int depth = 1)
+	{
+		unsigned int size = std::max({ width, height, depth }),
+			levels = 1;
+
+		while (size >>= 1)
+			++levels;
+
+		return levels;
+	}
+
+	// layers of arrays are not mipmapped
+	constexpr unsigned int mip_levels(TextureTarget target, unsigned int width,
+		unsigned int height = 1, unsigned int depth = 1)
+	{
+		switch (target)
+		{
+		case TextureTarget::texture_1d_array:
+			return mip_levels(width);
+		case TextureTarget::texture_2d_array:
+		case TextureTarget::texture_cube_map_array:
+			return mip_levels(width, height);
+		default:
+			return mip_levels(width, height, depth);
+		}
+	}
+
+	// offset of the pixels in the buffer bound to pixel_unpack target
+	struct unpack_offset
+	{
+		size_t offset;
+	};
+
+	constexpr bool is_sized_format(TexInternFormat format)
+	{
+		return format != TexInternFormat::none &&
+			format != TexInternFormat::red &&
+			format != TexInternFormat::rg &&
+			format != TexInternFormat::rgb &&
+			format != TexInternFormat::rgba;
+	}
+
+	// size of a 4x4 block, 0 - not a block compressed format
+	constexpr size_t compressed_block_bytes(TexInternFormat format)
+	{
+		switch (format)
+		{
+		case TexInternFormat::compressed_rgb_s3tc_dxt1:
+		case TexInternFormat::compressed_rgba_s3tc_dxt1:
+		case TexInternFormat::compressed_red_rgtc1:
+		case TexInternFormat::compressed_signed_red_rgtc1:
+		case TexInternFormat::compressed_rgb8_etc2:
+		case TexInternFormat::compressed_srgb8_etc2:
+			return 8;
+		case TexInternFormat::compressed_rgba_s3tc_dxt3:
+		case TexInternFormat::compressed_rgba_s3tc_dxt5:
+		case TexInternFormat::compressed_rg_rgtc2:
+		case TexInternFormat::compressed_signed_rg_rgtc2:
+		case TexInternFormat::compressed_rgba_bptc_unorm:
+		case TexInternFormat::compressed_srgb_alpha_bptc_unorm:
+		case TexInternFormat::compressed_rgba8_etc2_eac:
+		case TexInternFormat::compressed_srgb8_alpha8_etc2_eac:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	constexpr bool is_compressed_format(TexInternFormat format)
+	{
+		return compressed_block_bytes(format) != 0;
+	}
+
+	// size of a compressed image, partial blocks are padded
+	constexpr size_t compressed_image_bytes(TexInternFormat format,
+		unsigned int width, unsigned int height, unsigned int depth = 1)
+	{
+		return compressed_block_bytes(format) *
+			((width + 3) / 4) * ((height + 3) / 4) * depth;
+	}
+
+	// bytes of a texel of uncompressed formats, unsized formats are assumed 8-bit (rgb padded)
+	constexpr size_t texel_bytes(TexInternFormat format)
+	{
+		switch (format)
+		{
+		case TexInternFormat::red:
+		case TexInternFormat::r8:
+		case TexInternFormat::r8_snorm:
+		case TexInternFormat::r3_g3_b2:
+		case TexInternFormat::rgba2:
+			return 1;
+		case TexInternFormat::rg:
+		case TexInternFormat::rg8:
+		case TexInternFormat::rg8_snorm:
+		case TexInternFormat::r16:
+		case TexInternFormat::r16_snorm:
+		case TexInternFormat::r16f:
+		case TexInternFormat::rgb4:
+		case TexInternFormat::rgb5:
+		case TexInternFormat::rgba4:
+		case TexInternFormat::rgb5_a1:
+			return 2;
+		case TexInternFormat::rgb12:
+		case TexInternFormat::rgb16_snorm:
+		case TexInternFormat::rgb16f:
+		case TexInternFormat::rgba12:
+		case TexInternFormat::rgba16:
+		case TexInternFormat::rgba16f:
+			return 8;
+		case TexInternFormat::none:
+			return 0;
+		default:
+			return is_compressed_format(format) ? 0 : 4;
+		}
+	}
+
+	// bytes of a pixel of client memory, packed types hold all the components
+	constexpr size_t pixel_bytes(TexFormat format, TexType type)
+	{
+		size_t components = 0;
+		switch (format)
+		{
+		case TexFormat::red:
+		case TexFormat::red_integer:
+		case TexFormat::stencil_index:
+		case TexFormat::depth_component:
+			components = 1;
+			break;
+		case TexFormat::rd:
+		case TexFormat::rg_integer:
+		case TexFormat::depth_stencil:
+			components = 2;
+			break;
+		case TexFormat::rgb:
+		case TexFormat::bgr:
+		case TexFormat::rgb_integer:
+		case TexFormat::bgr_integer:
+			components = 3;
+			break;
+		default:
+			components = 4;
+			break;
+		}
+
+		switch (type)
+		{
+		case TexType::unsigned_byte:
+		case TexType::byte:
+			return components;
+		case TexType::unsigned_short:
+		case TexType::gl_short:
+		case TexType::half_float:
+			return components * 2;
+		case TexType::unsigned_int:
+		case TexType::gl_int:
+		case TexType::gl_float:
+			return components * 4;
+		case TexType::unsigned_byte_3_3_2:
+		case TexType::unsigned_byte_2_3_3_rev:
+			return 1;
+		case TexType::unsigned_short_5_6_5:
+		case TexType::unsigned_short_5_6_5_rev:
+		case TexType::unsigned_short_4_4_4_4:
+		case TexType::unsigned_short_4_4_4_4_rev:
+		case TexType::unsigned_short_5_5_5_1:
+		case TexType::unsigned_short_1_5_5_5_rev:
+			return 2;
+		default:
+			return 4;
+		}
+	}
+
+	// sizes of level 0 from the level specified last, layers of arrays are not mipmapped
+	inline std::array<unsigned int, 3> base_level_sizes(const texture_base& tex)
+	{
+		TextureTarget target = tex.Target();
+		unsigned int lod = tex.LOD();
+
+		auto base = [lod](unsigned int size, bool layers)
+		{
+			return !size ? 1u : (layers ? size : size << lod);
+		};
+
+		return {
+			base(tex.Width(), false),
+			base(tex.Height(), target == TextureTarget::texture_1d_array),
+			base(tex.Depth(), target == TextureTarget::texture_2d_array ||
+				target == TextureTarget::texture_cube_map_array)
+		};
+	}
+
+	// estimate of the video memory of the levels of a texture
+	inline size_t texture_bytes(const texture_base& tex, TexInternFormat format)
+	{
+		TextureTarget target = tex.Target();
+		std::array<unsigned int, 3> base = base_level_sizes(tex);
+
+		bool layersY = target == TextureTarget::texture_1d_array,
+			layersZ = target == TextureTarget::texture_2d_array ||
+				target == TextureTarget::texture_cube_map_array;
+
+		size_t bytes = 0;
+		for (unsigned int level = 0; level < std::max(1u, tex.Levels()); ++level)
+		{
+			unsigned int width = std::max(1u, base[0] >> level),
+				height = layersY ? base[1] : std::max(1u, base[1] >> level),
+				depth = layersZ ? base[2] : std::max(1u, base[2] >> level);
+
+			bytes += is_compressed_format(format) ?
+				compressed_image_bytes(format, width, height, depth) :
+				texel_bytes(format) * width * height * depth;
+		}
+
+		return target == TextureTarget::texture_cube_map ? bytes * 6 : bytes;
+	}
+
 	// base specialization
 	template <TextureTarget target, TexInternFormat format, 
 		size_t dims = get_tex_dim<target>(), bool base = !dims>
@@ -20,6 +242,13 @@ namespace glt
 			assert_bound_init();
 
 			glGenerateMipmap((GLenum)target);
+
+			// levels down to 1x1 are allocated
+			if (!modifier.state_.Immutable())
+			{
+				std::array<unsigned int, 3> sizes = base_level_sizes(modifier.state_);
+				modifier.SetLevels(mip_levels(target, sizes[0], sizes[1], sizes[2]));
+			}
 		}
 
 		void assert_bound_init()
@@ -28,6 +257,80 @@ namespace glt
 			assert(modifier.state_.Initialized() && "Texture is not initialized!");
 		}
 
+		void assert_mutable()
+		{
+			assert(!modifier.state_.Immutable() && "Immutable texture storage can not be respecified!");
+		}
+
+		// levels = 0 - full mip chain
+		unsigned int storage_levels(unsigned int levels, unsigned int maxLevels)
+		{
+			static_assert(is_sized_format(format), "Immutable storage requires sized internal format!");
+
+			assert_bound_init();
+			this->assert_mutable();
+			assert(levels <= maxLevels && "Too many levels for the texture size!");
+
+			return levels ? levels : maxLevels;
+		}
+
+		void set_image_level(unsigned int level)
+		{
+			modifier.SetLOD(level);
+			if (level >= modifier.state_.Levels())
+				modifier.SetLevels(level + 1);
+		}
+
+		/*
+		Uploads a mip chain computed on the CPU instead of GenerateMipMap, pixels - array of
+		the levels, level i is max(1, width >> i) x max(1, height >> i).
+		Chains shorter than the full one are sampled down to their last level.
+		Immutable storage is filled, otherwise the levels are specified.
+		Rows of the levels are tightly packed (unpack alignment of 1).
+		*/
+		void SetMipChain(unsigned int levels, unsigned int width, unsigned int height,
+			TexFormat pixelFormat, TexType type, const void* const* pixels)
+		{
+			static_assert(target == TextureTarget::texture_2d, "Mip chains are uploaded to 2D textures only!");
+
+			assert_bound_init();
+			assert(levels && levels <= mip_levels(width, height) && "Invalid number of levels!");
+			assert(!buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
+				"Attempt to set image while buffer is bound to pixel_unpack target!");
+
+			bool immutable = modifier.state_.Immutable();
+			assert((!immutable || levels <= modifier.state_.Levels()) &&
+				"Mip chain exceeds the levels of the storage!");
+
+			// rows of small levels of 3-component chains are not multiples of 4 bytes
+			GLint alignment = 4;
+			glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			for (unsigned int i = 0; i != levels; ++i)
+			{
+				GLsizei w = (GLsizei)std::max(1u, width >> i),
+					h = (GLsizei)std::max(1u, height >> i);
+
+				if (immutable)
+					glTexSubImage2D((GLenum)target, (GLint)i, 0, 0, w, h,
+						(GLenum)pixelFormat, (GLenum)type, pixels[i]);
+				else
+					glTexImage2D((GLenum)target, (GLint)i, (GLint)format, w, h, 0,
+						(GLenum)pixelFormat, (GLenum)type, pixels[i]);
+			}
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+			glTexParameteri((GLenum)target, GL_TEXTURE_MAX_LEVEL, (GLint)levels - 1);
+
+			if (immutable)
+				return;
+
+			modifier.SetLOD(0);
+			modifier.SetLevels(levels);
+			modifier.SetSizes(width, height);
+		}
+
 	};
 
 	// 1D specialization
@@ -38,11 +341,24 @@ namespace glt
 			: texture_image<target, intFormat, 0>(std::move(mod))
 		{}
 
+		// allocates all the levels at once, the storage can not be respecified
+		void SetStorage(unsigned int levels, unsigned int width)
+		{
+			levels = this->storage_levels(levels, mip_levels(width));
+
+			glTexStorage1D((GLenum)target, (GLsizei)levels, (GLenum)intFormat, (GLsizei)width);
+
+			modifier.SetLOD(0);
+			modifier.SetLevels(levels, true);
+			modifier.SetSizes(width);
+		}
+
 		// default format and type = red and unsigned byte
 		void SetImage(unsigned int level, unsigned int width)//,
 		//	TexFormat format, TexType type)
 		{
 			assert_bound_init();
+			this->assert_mutable();
 
 			assert(!buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
 				"Attempt to set image while buffer is bound to pixel_unpack target!");
@@ -51,7 +367,7 @@ namespace glt
 				(GLsizei)width, 0, 
 				(GLenum)TexFormat::red, (GLenum)TexType::unsigned_byte, nullptr);
 
-			modifier.SetLOD(level);
+			this->set_image_level(level);
 			modifier.SetSizes(width);
 		}
 
@@ -69,6 +385,27 @@ namespace glt
 				(GLsizei)width, (GLenum)format, (GLenum)type, pixels);
 		}
 
+		// compressed formats (BCn, ETC2) consist of 4x4 blocks, 1D targets do not accept them
+		template <typename ... Args>
+		void CompressedImage(Args&& ...) = delete;
+
+		template <typename ... Args>
+		void CompressedSubImage(Args&& ...) = delete;
+
+		// pixels are sourced from the buffer bound to pixel_unpack target
+		void SubImage(unsigned int level, unsigned int width,
+			TexFormat format, TexType type, unpack_offset pixels,
+			int xoffset = 0)
+		{
+			assert_bound_init();
+
+			assert(buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
+				"No buffer is bound to pixel_unpack target!");
+
+			glTexSubImage1D((GLenum)target, (GLint)level, (GLint)xoffset,
+				(GLsizei)width, (GLenum)format, (GLenum)type, (const void*)pixels.offset);
+		}
+
 	};
 
 	// 2D specialization
@@ -79,11 +416,25 @@ namespace glt
 			: texture_image<target, intFormat, 0>(std::move(mod))
 		{}
 
+		// allocates all the levels at once, the storage can not be respecified
+		void SetStorage(unsigned int levels, unsigned int width, unsigned int height)
+		{
+			levels = this->storage_levels(levels, mip_levels(target, width, height));
+
+			glTexStorage2D((GLenum)target, (GLsizei)levels, (GLenum)intFormat,
+				(GLsizei)width, (GLsizei)height);
+
+			modifier.SetLOD(0);
+			modifier.SetLevels(levels, true);
+			modifier.SetSizes(width, height);
+		}
+
 		// default format and type = red and unsigned byte
 		void SetImage(unsigned int level, unsigned int width, unsigned int height)//,
 			//TexFormat format, TexType type)
 		{
 			assert_bound_init();
+			this->assert_mutable();
 
 			assert(!buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
 				"Attempt to set image while buffer is bound to pixel_unpack target!");
@@ -92,7 +443,7 @@ namespace glt
 				(GLsizei)width, (GLsizei)height, 0, 
 				(GLenum)TexFormat::red, (GLenum)TexType::unsigned_byte, nullptr);
 			
-			modifier.SetLOD(level);
+			this->set_image_level(level);
 			modifier.SetSizes(width, height);
 		}
 
@@ -113,6 +464,183 @@ namespace glt
 				pixels);
 		}
 
+		// blocks of the compressed internal format
+		void CompressedImage(unsigned int level, unsigned int width, unsigned int height,
+			const void* blocks, size_t size)
+		{
+			static_assert(is_compressed_format(intFormat), "Internal format is not compressed!");
+			static_assert(target != TextureTarget::texture_1d_array &&
+				target != TextureTarget::texture_rectangle,
+				"Compressed formats are not accepted by 1D array and rectangle textures!");
+
+			assert_bound_init();
+			this->assert_mutable();
+			assert(size == compressed_image_bytes(intFormat, width, height) &&
+				"Invalid size of compressed image!");
+
+			glCompressedTexImage2D((GLenum)target, (GLint)level, (GLenum)intFormat,
+				(GLsizei)width, (GLsizei)height, 0, (GLsizei)size, blocks);
+
+			this->set_image_level(level);
+			modifier.SetSizes(width, height);
+		}
+
+		// offsets must be multiples of 4
+		void CompressedSubImage(unsigned int level, unsigned int width, unsigned int height,
+			const void* blocks, size_t size, int xoffset = 0, int yoffset = 0)
+		{
+			static_assert(is_compressed_format(intFormat), "Internal format is not compressed!");
+			static_assert(target != TextureTarget::texture_1d_array &&
+				target != TextureTarget::texture_rectangle,
+				"Compressed formats are not accepted by 1D array and rectangle textures!");
+
+			assert_bound_init();
+			assert(!(xoffset % 4) && !(yoffset % 4) && "Offsets are not aligned to blocks!");
+			assert(size == compressed_image_bytes(intFormat, width, height) &&
+				"Invalid size of compressed image!");
+
+			glCompressedTexSubImage2D((GLenum)target, (GLint)level,
+				(GLint)xoffset, (GLint)yoffset,
+				(GLsizei)width, (GLsizei)height,
+				(GLenum)intFormat, (GLsizei)size, blocks);
+		}
+
+		// pixels are sourced from the buffer bound to pixel_unpack target
+		void SubImage(unsigned int level, unsigned int width, unsigned int height,
+			TexFormat format, TexType type, unpack_offset pixels,
+			int xoffset = 0, int yoffset = 0)
+		{
+			assert_bound_init();
+
+			assert(buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
+				"No buffer is bound to pixel_unpack target!");
+
+			glTexSubImage2D((GLenum)target, (GLint)level,
+				(GLint)xoffset, (GLint)yoffset,
+				(GLsizei)width, (GLsizei)height,
+				(GLenum)format, (GLenum)type,
+				(const void*)pixels.offset);
+		}
+
+	};
+
+	// cube map specialization, images are specified per face
+	template <TexInternFormat intFormat>
+	struct texture_image<TextureTarget::texture_cube_map, intFormat, 2> :
+		public texture_image<TextureTarget::texture_cube_map, intFormat, 0>
+	{
+		texture_image(texture_base::modifier&& mod)
+			: texture_image<TextureTarget::texture_cube_map, intFormat, 0>(std::move(mod))
+		{}
+
+		constexpr static bool is_face(TextureTarget face)
+		{
+			return (GLenum)face >= GL_TEXTURE_CUBE_MAP_POSITIVE_X &&
+				(GLenum)face <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z;
+		}
+
+		// all the faces are allocated, faces are square
+		void SetStorage(unsigned int levels, unsigned int size)
+		{
+			levels = this->storage_levels(levels, mip_levels(size));
+
+			glTexStorage2D(GL_TEXTURE_CUBE_MAP, (GLsizei)levels, (GLenum)intFormat,
+				(GLsizei)size, (GLsizei)size);
+
+			modifier.SetLOD(0);
+			modifier.SetLevels(levels, true);
+			modifier.SetSizes(size, size);
+		}
+
+		// default format and type = red and unsigned byte
+		void SetImage(TextureTarget face, unsigned int level, unsigned int size)
+		{
+			assert(is_face(face) && "Invalid cube map face!");
+			assert_bound_init();
+			this->assert_mutable();
+
+			assert(!buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
+				"Attempt to set image while buffer is bound to pixel_unpack target!");
+
+			glTexImage2D((GLenum)face, (GLint)level, (GLint)intFormat,
+				(GLsizei)size, (GLsizei)size, 0,
+				(GLenum)TexFormat::red, (GLenum)TexType::unsigned_byte, nullptr);
+
+			this->set_image_level(level);
+			modifier.SetSizes(size, size);
+		}
+
+		void SubImage(TextureTarget face, unsigned int level, unsigned int width, unsigned int height,
+			TexFormat format, TexType type, const void* pixels,
+			int xoffset = 0, int yoffset = 0)
+		{
+			assert(is_face(face) && "Invalid cube map face!");
+			assert_bound_init();
+
+			assert(!buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
+				"Attempt to set image while buffer is bound to pixel_unpack target!");
+
+			glTexSubImage2D((GLenum)face, (GLint)level,
+				(GLint)xoffset, (GLint)yoffset,
+				(GLsizei)width, (GLsizei)height,
+				(GLenum)format, (GLenum)type,
+				pixels);
+		}
+
+		// pixels are sourced from the buffer bound to pixel_unpack target
+		void SubImage(TextureTarget face, unsigned int level, unsigned int width, unsigned int height,
+			TexFormat format, TexType type, unpack_offset pixels,
+			int xoffset = 0, int yoffset = 0)
+		{
+			assert(is_face(face) && "Invalid cube map face!");
+			assert_bound_init();
+
+			assert(buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
+				"No buffer is bound to pixel_unpack target!");
+
+			glTexSubImage2D((GLenum)face, (GLint)level,
+				(GLint)xoffset, (GLint)yoffset,
+				(GLsizei)width, (GLsizei)height,
+				(GLenum)format, (GLenum)type,
+				(const void*)pixels.offset);
+		}
+
+		void CompressedImage(TextureTarget face, unsigned int level, unsigned int size,
+			const void* blocks, size_t blocksSize)
+		{
+			static_assert(is_compressed_format(intFormat), "Internal format is not compressed!");
+
+			assert(is_face(face) && "Invalid cube map face!");
+			assert_bound_init();
+			this->assert_mutable();
+			assert(blocksSize == compressed_image_bytes(intFormat, size, size) &&
+				"Invalid size of compressed image!");
+
+			glCompressedTexImage2D((GLenum)face, (GLint)level, (GLenum)intFormat,
+				(GLsizei)size, (GLsizei)size, 0, (GLsizei)blocksSize, blocks);
+
+			this->set_image_level(level);
+			modifier.SetSizes(size, size);
+		}
+
+		void CompressedSubImage(TextureTarget face, unsigned int level,
+			unsigned int width, unsigned int height,
+			const void* blocks, size_t size, int xoffset = 0, int yoffset = 0)
+		{
+			static_assert(is_compressed_format(intFormat), "Internal format is not compressed!");
+
+			assert(is_face(face) && "Invalid cube map face!");
+			assert_bound_init();
+			assert(!(xoffset % 4) && !(yoffset % 4) && "Offsets are not aligned to blocks!");
+			assert(size == compressed_image_bytes(intFormat, width, height) &&
+				"Invalid size of compressed image!");
+
+			glCompressedTexSubImage2D((GLenum)face, (GLint)level,
+				(GLint)xoffset, (GLint)yoffset,
+				(GLsizei)width, (GLsizei)height,
+				(GLenum)intFormat, (GLsizei)size, blocks);
+		}
+
 	};
 
 	// 3D specialization
@@ -123,11 +651,26 @@ namespace glt
 			: texture_image<target, intFormat, 0>(std::move(mod))
 		{}
 
+		// allocates all the levels at once, the storage can not be respecified
+		void SetStorage(unsigned int levels,
+			unsigned int width, unsigned int height, unsigned int depth)
+		{
+			levels = this->storage_levels(levels, mip_levels(target, width, height, depth));
+
+			glTexStorage3D((GLenum)target, (GLsizei)levels, (GLenum)intFormat,
+				(GLsizei)width, (GLsizei)height, (GLsizei)depth);
+
+			modifier.SetLOD(0);
+			modifier.SetLevels(levels, true);
+			modifier.SetSizes(width, height, depth);
+		}
+
 		void SetImage(unsigned int level, 
 			unsigned int width, unsigned int height, unsigned int depth)//,
 			//TexFormat format, TexType type)
 		{
 			assert_bound_init();
+			this->assert_mutable();
 
 			assert(!buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
 				"Attempt to set image while buffer is bound to pixel_unpack target!");
@@ -138,7 +681,7 @@ namespace glt
 				0, 
 				(GLenum)TexFormat::red, (GLenum)TexType::unsigned_byte, nullptr);
 
-			modifier.SetLOD(level);
+			this->set_image_level(level);
 			modifier.SetSizes(width, height, depth);
 		}
 
@@ -160,6 +703,61 @@ namespace glt
 				pixels);
 		}
 
+		// blocks of the compressed internal format, depth - layers of 4x4 blocks
+		void CompressedImage(unsigned int level,
+			unsigned int width, unsigned int height, unsigned int depth,
+			const void* blocks, size_t size)
+		{
+			static_assert(is_compressed_format(intFormat), "Internal format is not compressed!");
+
+			assert_bound_init();
+			this->assert_mutable();
+			assert(size == compressed_image_bytes(intFormat, width, height, depth) &&
+				"Invalid size of compressed image!");
+
+			glCompressedTexImage3D((GLenum)target, (GLint)level, (GLenum)intFormat,
+				(GLsizei)width, (GLsizei)height, (GLsizei)depth, 0, (GLsizei)size, blocks);
+
+			this->set_image_level(level);
+			modifier.SetSizes(width, height, depth);
+		}
+
+		void CompressedSubImage(unsigned int level,
+			unsigned int width, unsigned int height, unsigned int depth,
+			const void* blocks, size_t size,
+			int xoffset = 0, int yoffset = 0, int zoffset = 0)
+		{
+			static_assert(is_compressed_format(intFormat), "Internal format is not compressed!");
+
+			assert_bound_init();
+			assert(!(xoffset % 4) && !(yoffset % 4) && "Offsets are not aligned to blocks!");
+			assert(size == compressed_image_bytes(intFormat, width, height, depth) &&
+				"Invalid size of compressed image!");
+
+			glCompressedTexSubImage3D((GLenum)target, (GLint)level,
+				(GLint)xoffset, (GLint)yoffset, (GLint)zoffset,
+				(GLsizei)width, (GLsizei)height, (GLsizei)depth,
+				(GLenum)intFormat, (GLsizei)size, blocks);
+		}
+
+		// pixels are sourced from the buffer bound to pixel_unpack target
+		void SubImage(unsigned int level,
+			unsigned int width, unsigned int height, unsigned int depth,
+			TexFormat format, TexType type, unpack_offset pixels,
+			int xoffset = 0, int yoffset = 0, int zoffset = 0)
+		{
+			assert_bound_init();
+
+			assert(buffer_base::TargetMapped(BufferTarget::pixel_unpack) &&
+				"No buffer is bound to pixel_unpack target!");
+
+			glTexSubImage3D((GLenum)target, (GLint)level,
+				(GLint)xoffset, (GLint)yoffset, (GLint)zoffset,
+				(GLsizei)width, (GLsizei)height, (GLsizei)depth,
+				(GLenum)format, (GLenum)type,
+				(const void*)pixels.offset);
+		}
+
 	};
 
     template <TextureTarget target, TexInternFormat intFormat>
@@ -174,8 +772,7 @@ namespace glt
 
         void bind_after_init()
         {
-            glBindTexture((GLenum)target, handle_accessor(handle_));
-            texture_base::Register<target>(this);
+            gl_state::Current().BindTexture(target, handle_accessor(handle_));
         }
 
         void bind_before_init()
@@ -194,31 +791,45 @@ namespace glt
 			texture_image(texture_base::GetModifier())
         {}
 
+        texture_base_target(const texture_base_target& other, share_tag tag)
+            : texture_base(other, tag),
+			texture_image(texture_base::GetModifier()),
+            pBind_(other.pBind_)
+        {}
+
         texture_base_target(texture_base_target&& other)
             : texture_base(std::move(other)),
-			texture_image(texture_base::GetModifier())
+			texture_image(texture_base::GetModifier()),
+            pBind_(other.pBind_)
         {
-            if (IsBound())
-                Register<target>(this);
-
             other.pBind_ = &texture_base_target::bind_before_init;
         }
 
+        // bind to the active texture unit
         void Bind()
         {
             (this->*pBind_)();
         }
 
-#pragma message("Need to implement check for active GL_TEXTURE_N")
+        // makes the unit active and binds the texture to it
+        void Bind(GLuint unit)
+        {
+            gl_state::Current().ActiveTexture(unit);
+            Bind();
+        }
+
         void UnBind()
         {
             assert(texture_base::IsBound() && "Attempt to unbind non-active texture!");
-            glBindTexture((GLenum)target_, 0);
-            texture_base::Register<target>();
+            gl_state::Current().BindTexture(target, 0);
         }
 
 		using tex_image::SetImage;
+		using tex_image::SetStorage;
 		using tex_image::SubImage;
+		using tex_image::CompressedImage;
+		using tex_image::CompressedSubImage;
+		using tex_image::SetMipChain;
 
     };
 
@@ -100,6 +100,19 @@ namespace glt
 	template <typename glObjType>
 	constexpr inline auto pp_gl_deleter_v = pp_gl_deleter<glObjType>::value;
 
+	// types of OpenGL objects
+	using TargetTypes = std::tuple<BufferTarget,
+		FrameBufTarget,
+		TextureTarget,
+		VAOTarget,
+		TransformFeedBackTarget,
+		QueryTarget,
+		ProgramPipeLineTarget,
+		RenderBufferTarget,
+		SamplerTarget,
+		ShaderTarget,
+		ProgramTarget>;
+
 	template <typename glObjType>
 	constexpr inline bool has_func_bind_v = std::bool_constant<std::disjunction_v<
 		std::is_same<glObjType, BufferTarget>,
@@ -307,13 +320,15 @@ namespace glt
 	template <> struct pp_gl_get_uniform_map<int> : glt_constant<&glGetUniformiv> {};
 	template <> struct pp_gl_get_uniform_map<unsigned int> : glt_constant<&glGetUniformuiv> {};
 
+    // dimensions of the images specifying the texture, layers of arrays are the last dimension
     template <TextureTarget target>
     struct get_tex_dim;
 
     template <> struct get_tex_dim<TextureTarget::texture_1d> : std::integral_constant<size_t, 1> {};
-    template <> struct get_tex_dim<TextureTarget::texture_1d_array> : std::integral_constant<size_t, 1> {};
+    template <> struct get_tex_dim<TextureTarget::texture_1d_array> : std::integral_constant<size_t, 2> {};
     template <> struct get_tex_dim<TextureTarget::texture_2d> : std::integral_constant<size_t, 2> {};
-    template <> struct get_tex_dim<TextureTarget::texture_2d_array> : std::integral_constant<size_t, 2> {};
+    template <> struct get_tex_dim<TextureTarget::texture_2d_array> : std::integral_constant<size_t, 3> {};
+    template <> struct get_tex_dim<TextureTarget::texture_cube_map> : std::integral_constant<size_t, 2> {};
     template <> struct get_tex_dim<TextureTarget::texture_2d_multisample> : std::integral_constant<size_t, 2> {};
     template <> struct get_tex_dim<TextureTarget::texture_2d_multisample_array> : std::integral_constant<size_t, 2> {};
     template <> struct get_tex_dim<TextureTarget::texture_3d> : std::integral_constant<size_t, 3> {};
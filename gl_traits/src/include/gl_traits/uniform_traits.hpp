@@ -31,6 +31,8 @@ namespace glt
 	/////////////////
 	// Public class
 	/////////////////
+	// Uniform shadows the value it has set last, thus setting an unchanged value and
+	// getting the value do not call OpenGL. Values set bypassing the Uniform are not shadowed.
 	template <class T, class =
 		decltype(std::make_index_sequence<seq_elem_count<T>>())>
 		class Uniform;
@@ -41,8 +43,8 @@ namespace glt
 	{
 	
 	protected:
-		Uniform(const program_base& prog, const char* name)
-			: uniform_base(prog, name)
+		Uniform(const program_base& prog, const char* name, GLint explicitLocation = -1)
+			: uniform_base(prog, name, explicitLocation)
 		{}
 
         using uniform_base::GetLocation;
@@ -56,11 +58,15 @@ namespace glt
 		using ret_type = std::conditional_t<(elems_count > 1), 
 			glm_type, c_type>;
 
+		// the call is skipped if the value has not changed since the last Set
 		void Set(convert_v_to<c_type, indx> ... val)
 		{
 			assert(prog_.IsActive() &&
 				"Attempting to set uniform for non-active program!");
 
+			if (!Shadow(ret_type(val...)))
+				return;
+
 			p_gl_uniform_t<T, elems_count> pglUniformT =
 				get_p_gl_uniform<c_type, elems_count>();
 
@@ -72,6 +78,9 @@ namespace glt
 			assert(prog_.IsActive() &&
 				"Attempting to set uniform for non-active program!");
 
+			if (!Shadow(ret_type(val)))
+				return;
+
 			p_gl_uniform_t<glm_type> pglUniformT =
 				get_p_gl_uniform<glm_type>();
 
@@ -79,7 +88,20 @@ namespace glt
 			(*pglUniformT)(location_, 1, &val);
 		}
 
+		// returns the shadow value, queries OpenGL only if it is unknown
 		void Get(ret_type &ret) const
+		{
+			if (!shadowed_)
+			{
+				Query(shadow_);
+				shadowed_ = true;
+			}
+
+			ret = shadow_;
+		}
+
+		// bypasses the shadow value
+		void Query(ret_type &ret) const
 		{
             using FuncGet = void(*)(GLint, GLint, ret_type&);
             FuncGet ptr = reinterpret_cast<FuncGet>(*pp_gl_get_uniform_map<c_type>());
@@ -96,6 +118,21 @@ namespace glt
 			return ret;
 		}
 
+	private:
+
+		mutable ret_type shadow_{};
+
+		// false if the value is already set
+		bool Shadow(const ret_type& val)
+		{
+			if (shadowed_ && shadow_ == val)
+				return false;
+
+			shadow_ = val;
+			shadowed_ = true;
+			return true;
+		}
+
 	};
 
 
@@ -106,8 +143,8 @@ namespace glt
 		protected uniform_base
 	{
 	protected:
-		Uniform(const program_base& prog, const char* name)
-			: uniform_base(prog, name)
+		Uniform(const program_base& prog, const char* name, GLint explicitLocation = -1)
+			: uniform_base(prog, name, explicitLocation)
 		{}
         
         using uniform_base::GetLocation;
@@ -125,6 +162,12 @@ namespace glt
 			assert(prog_.IsActive() &&
 				"Attempting to set uniform for non-active program!");
 
+			// transposed values are not shadowed
+			if (transpose)
+				shadowed_ = false;
+			else if (!Shadow(val))
+				return;
+
 			p_gl_uniform_t<glm_type> pglUniformT =
 				get_p_gl_uniform<glm_type, 1>();
 
@@ -132,7 +175,20 @@ namespace glt
 			(*pglUniformT)(location_, 1, transpose, val);
 		}
 
+		// returns the shadow value, queries OpenGL only if it is unknown
 		void Get(ret_type &ret) const
+		{
+			if (!shadowed_)
+			{
+				Query(shadow_);
+				shadowed_ = true;
+			}
+
+			ret = shadow_;
+		}
+
+		// bypasses the shadow value
+		void Query(ret_type &ret) const
 		{
             using FuncGet = void(*)(GLint, GLint, ret_type&);
             FuncGet ptr = reinterpret_cast<FuncGet>(*pp_gl_get_uniform_map<c_type>());
@@ -147,6 +203,21 @@ namespace glt
 
 			return ret;
 		}
+
+	private:
+
+		mutable ret_type shadow_{};
+
+		// false if the value is already set
+		bool Shadow(const ret_type& val)
+		{
+			if (shadowed_ && shadow_ == val)
+				return false;
+
+			shadow_ = val;
+			shadowed_ = true;
+			return true;
+		}
 	};
 
 	template <class GLSL>
@@ -159,7 +230,7 @@ namespace glt
 	protected:
 
 		named_uniform(const program_base& prog)
-			: unif_type(prog, variable_traits_name<GLSL>)
+			: unif_type(prog, variable_traits_name<GLSL>, variable_traits_location<GLSL>)
 		{}
 
         void GetLocation()
@@ -206,6 +277,8 @@ namespace glt
 			: uniform_i<indx>(prog)...
 		{}
 
+        // explicit locations (glt_location) are used as is, the others
+        // are queried by name
         void GetLocations()
         {
             (uniform_i<indx>::GetLocation(), ...);
@@ -0,0 +1,170 @@
+#pragma once
+
+/*
+Worker thread that creates and uploads resources (Buffers, Textures, etc) in an
+OpenGL context shared with the render context.
+
+Tasks are executed in order on the worker thread. Before a task's future becomes
+ready, the worker waits on a fence, so that the uploaded data is complete and
+can be used by the render thread. Objects created by a task are moved to the
+render thread through the future.
+
+    UploadThread uploader{ [&]() { glfwMakeContextCurrent(sharedWindow); } };
+
+    std::future<Texture2Drgba> tex = uploader.Submit([&]()
+    {
+        Texture2Drgba texture;
+        ...
+        return texture;
+    });
+
+Note: a shared context must be created by the windowing library before the
+UploadThread and must not be current on any other thread.
+*/
+
+#include "context.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace glt
+{
+    class UploadThread
+    {
+        std::function<void()> makeCurrent_,
+            doneCurrent_;
+
+        std::deque<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stop_ = false;
+
+        std::thread thread_;
+
+    public:
+
+        // makeCurrent is invoked on the worker thread to make the shared context current,
+        // doneCurrent - before the worker thread exits
+        UploadThread(std::function<void()> makeCurrent,
+            std::function<void()> doneCurrent = std::function<void()>())
+            : makeCurrent_(std::move(makeCurrent)),
+            doneCurrent_(std::move(doneCurrent)),
+            thread_(&UploadThread::Run, this)
+        {}
+
+        UploadThread(const UploadThread&) = delete;
+        UploadThread& operator=(const UploadThread&) = delete;
+
+        // pending tasks are completed before the thread is joined
+        ~UploadThread()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+
+            cv_.notify_one();
+            thread_.join();
+        }
+
+        template <typename F>
+        std::future<std::invoke_result_t<std::decay_t<F>>> Submit(F&& task)
+        {
+            using result_type = std::invoke_result_t<std::decay_t<F>>;
+
+            // std::function requires copyable callables
+            auto promise = std::make_shared<std::promise<result_type>>();
+            std::future<result_type> future = promise->get_future();
+
+            auto wrapper = [promise, task = std::forward<F>(task)]() mutable
+            {
+                try
+                {
+                    if constexpr (std::is_void_v<result_type>)
+                    {
+                        task();
+                        Finish();
+                        promise->set_value();
+                    }
+                    else
+                    {
+                        result_type result = task();
+                        Finish();
+                        promise->set_value(std::move(result));
+                    }
+                }
+                catch (...)
+                {
+                    promise->set_exception(std::current_exception());
+                }
+            };
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.emplace_back(std::move(wrapper));
+            }
+
+            cv_.notify_one();
+            return future;
+        }
+
+    private:
+
+        void Run()
+        {
+            Context context;
+
+            makeCurrent_();
+            context.MakeCurrent();
+
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+
+                    if (tasks_.empty())
+                        break;
+
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+
+                task();
+
+                // objects bound by the task may be deleted by other contexts
+                // and their names reused
+                context.State().Invalidate();
+            }
+
+            Context::ReleaseCurrent();
+            if (doneCurrent_)
+                doneCurrent_();
+        }
+
+        // waits until the commands issued by the task have been completed
+        static void Finish()
+        {
+            GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+            GLenum res = GL_TIMEOUT_EXPIRED;
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            while (res == GL_TIMEOUT_EXPIRED)
+            {
+                res = glClientWaitSync(fence, flags, 1000000);
+                flags = 0;
+            }
+
+            glDeleteSync(fence);
+            assert(res != GL_WAIT_FAILED && "Failed to wait for upload fence!");
+        }
+    };
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sequence_layout.hpp"
+#include "buffer_traits.hpp"
 
 namespace glt
 {
@@ -10,15 +11,18 @@ namespace glt
     template <size_t indx, class Attrib, bool = has_name_v<Attrib>>
     class vao_attrib_modify
     {
-        const vao_base& rVao_;
+        vao_base& rVao_;
 
     public:
 		
-        // TODO: track enabled pointers?
         void EnablePointer(tag_s<indx>) const
         {
-            assert(rVao_.IsBound());
-            glEnableVertexAttribArray((GLuint)indx);
+            rVao_.EnableArray((GLuint)indx);
+        }
+
+        void DisablePointer(tag_s<indx>) const
+        {
+            rVao_.DisableArray((GLuint)indx);
         }
 
         void AttributePointer(tag_s<indx>, AttribPtr<Attrib>&& attrib, bool normalize = false)
@@ -43,6 +47,24 @@ namespace glt
                 (GLsizei)attrib.stride,
                 (void*)attrib.offset);
         }
+
+        // separate attribute format (GL 4.3 vertex_attrib_binding),
+        // the buffer is supplied later via VAO::BindVertexBuffer
+        void AttributeFormat(tag_s<indx>, GLuint binding, size_t relOffset = 0, bool normalize = false)
+        {
+            assert(rVao_.IsBound() &&
+                "Setting Vertex Attribute Format for non-active VAO");
+
+            using unwrapped_type = variable_traits_type<Attrib>;
+
+            glVertexAttribFormat((GLuint)indx,
+                (GLint)sequence_traits<unwrapped_type>::elem_count,
+                (GLenum)c_to_gl_v<unwrapped_type>,
+                normalize,
+                (GLuint)relOffset);
+
+            glVertexAttribBinding((GLuint)indx, binding);
+        }
         
         template <typename T, typename = std::enable_if_t<is_equivalent_v<T, Attrib>>>
         void AttributePointer(tag_s<indx>, AttribPtr<T>&& attrib, bool normalize = false)
@@ -52,7 +74,7 @@ namespace glt
         }
 
     protected:
-        vao_attrib_modify(const vao_base& rVao)
+        vao_attrib_modify(vao_base& rVao)
             : rVao_(rVao)
         {}
     };
@@ -67,20 +89,31 @@ namespace glt
     public:
 		
         using vao_attrib_nameless::EnablePointer;
+        using vao_attrib_nameless::DisablePointer;
         using vao_attrib_nameless::AttributePointer;
+        using vao_attrib_nameless::AttributeFormat;
 
         void EnablePointer(tag_t<Attrib>)
         {
             vao_attrib_nameless::EnablePointer(tag_s<indx>());
         }
+        void DisablePointer(tag_t<Attrib>)
+        {
+            vao_attrib_nameless::DisablePointer(tag_s<indx>());
+        }
         void AttributePointer(AttribPtr<Attrib>&& attrib, bool normalize = false)
         {
             vao_attrib_nameless::AttributePointer(tag_s<indx>(),
                 std::move(attrib), normalize);
         }
+        void AttributeFormat(tag_t<Attrib>, GLuint binding, size_t relOffset = 0, bool normalize = false)
+        {
+            vao_attrib_nameless::AttributeFormat(tag_s<indx>(),
+                binding, relOffset, normalize);
+        }
 
     protected:
-        vao_attrib_modify(const vao_base& rVao)
+        vao_attrib_modify(vao_base& rVao)
             : vao_attrib_nameless(rVao)
         {}
     };
@@ -100,41 +133,41 @@ namespace glt
         using vao_attrib_i =
             vao_attrib_modify<i, std::tuple_element_t<i, std::tuple<Attribs...>>>;
 
-        // for run-time wrapper function
-        template <size_t i>
-        using PtrEnable = void(aggregated_vao_attribs::*)(tag_s<i>) const;
-
-        template <size_t i>
-        constexpr static PtrEnable<i> enable_ptr = &aggregated_vao_attribs::EnablePointer;
-
-        // dummy to typename to store function pointers
-        template <size_t i>
-        constexpr static PtrEnable<0> enable_ptr_0 =
-            reinterpret_cast<PtrEnable<0>>(enable_ptr<i>);
-
     public:
 
-        aggregated_vao_attribs(const vao_base& vao)
+        aggregated_vao_attribs(vao_base& vao)
             : vao_attrib_i<indx>(vao)...
         {}
 
         using vao_attrib_i<indx>::EnablePointer...;
+        using vao_attrib_i<indx>::DisablePointer...;
         using vao_attrib_i<indx>::AttributePointer...;
+        using vao_attrib_i<indx>::AttributeFormat...;
 
-        // run-time pointer activation
-        void EnablePointer(size_t i)
+        // separate format, batched layout:
+        // attribute i is sourced from the binding point i
+        void SetFormat(bool normalize = false)
         {
-            constexpr static PtrEnable<0> enableTable[]{
-                enable_ptr_0<indx>...
-            };
+            (AttributeFormat(tag_s<indx>(), (GLuint)indx, 0, normalize), ...);
+        }
 
-            (this->*enableTable[i])(tag_s<0>());
+        // separate format, compound layout:
+        // all attributes are sourced from a single interleaved sequence
+        void SetCompoundFormat(GLuint binding = 0, bool normalize = false)
+        {
+            (AttributeFormat(tag_s<indx>(), binding,
+                get_member_offset_v<indx, variable_traits_type<Attribs>...>, normalize), ...);
         }
 
         void EnablePointers()
         {
             (EnablePointer(tag_s<indx>()), ...);
         }
+
+        void DisablePointers()
+        {
+            (DisablePointer(tag_s<indx>()), ...);
+        }
     };
 
 	/*
@@ -165,14 +198,254 @@ namespace glt
 	public:
         VAO(HandleVAO&& handle = Allocator::Allocate(VAOTarget()))
 			: vao_base(std::move(handle)),
-            aggr_attribs(static_cast<const vao_base&>(*this))
+            aggr_attribs(static_cast<vao_base&>(*this))
 		{}
 
         using aggr_attribs::EnablePointer;
         using aggr_attribs::EnablePointers;
+        using aggr_attribs::DisablePointer;
+        using aggr_attribs::DisablePointers;
+
+        // run-time pointer activation
+        void EnablePointer(size_t i)
+        {
+            assert(i < sizeof...(Attribs) && "Invalid attribute index!");
+            EnableArray((GLuint)i);
+        }
+
+        void DisablePointer(size_t i)
+        {
+            assert(i < sizeof...(Attribs) && "Invalid attribute index!");
+            DisableArray((GLuint)i);
+        }
         using aggr_attribs::AttributePointer;
+        using aggr_attribs::AttributeFormat;
+        using aggr_attribs::SetFormat;
+        using aggr_attribs::SetCompoundFormat;
+
+        /*
+        Attach a sequence to the binding point of the separate format.
+        Single attribute sequence must match the attribute at the binding index (batched layout),
+        compound sequence must match all the attributes of the VAO (compound layout).
+        Meshes with the same vertex type may share one VAO and only rebind their buffers.
+        */
+        template <size_t binding, class ... Attrs>
+        void BindVertexBuffer(tag_s<binding>, const Sequence<Attrs...>& seq, size_t inst_offset = 0)
+        {
+            static_assert(is_binding_compatible<binding, Attrs...>(),
+                "Sequence does not match the attributes sourced from the binding point!");
+
+            assert(IsBound() && "Binding vertex buffer to non-active VAO");
+
+            glBindVertexBuffer((GLuint)binding,
+                handle_accessor(seq.BufferHandle()),
+                (GLintptr)(seq.BufferOffset() + seq.elem_size * inst_offset),
+                (GLsizei)seq.elem_size);
+        }
+
+        // batched layout: attach all the sequences with a single call (GL 4.4)
+        template <class ... Seq>
+        void BindVertexBuffers(const Sequence<Seq>& ... seqs)
+        {
+            static_assert(sizeof...(Seq) == sizeof...(Attribs),
+                "Number of sequences does not match the number of attributes!");
+            static_assert(std::conjunction_v<std::bool_constant<
+                is_equivalent_v<variable_traits_type<Seq>, variable_traits_type<Attribs>>>...>,
+                "Sequences do not match the attributes!");
+
+            assert(IsBound() && "Binding vertex buffers to non-active VAO");
+
+            const GLuint buffers[]{ handle_accessor(seqs.BufferHandle())... };
+            const GLintptr offsets[]{ (GLintptr)seqs.BufferOffset()... };
+            const GLsizei strides[]{ (GLsizei)seqs.elem_size... };
+
+            glBindVertexBuffers(0, (GLsizei)sizeof...(Seq), buffers, offsets, strides);
+        }
+
+        /*
+        Record the element buffer in the VAO state, draws with the VAO do not rebind it
+        (see ProgGuard::DrawElements). Must be recorded again after the indices are reallocated.
+        */
+        void BindElementBuffer(const Buffer<GLuint>& elements)
+        {
+            SetElementBuffer(handle_accessor(elements.Handle()), elements().Allocated());
+        }
+
+        void UnBindElementBuffer()
+        {
+            SetElementBuffer(0, 0);
+        }
+
+        using vao_base::ElementBuffer;
+        using vao_base::ElementCount;
+
+    private:
+
+        template <size_t binding, class ... Attrs>
+        constexpr static bool is_binding_compatible()
+        {
+            if constexpr (sizeof...(Attrs) == 1)
+            {
+                if constexpr (binding < sizeof...(Attribs))
+                    return is_equivalent_v<variable_traits_type<Attrs>...,
+                        variable_traits_type<std::tuple_element_t<binding, std::tuple<Attribs...>>>>;
+                else
+                    return false;
+            }
+            else if constexpr (sizeof...(Attrs) == sizeof...(Attribs))
+                return std::conjunction_v<std::bool_constant<
+                    is_equivalent_v<variable_traits_type<Attrs>, variable_traits_type<Attribs>>>...>;
+            else
+                return false;
+        }
 		   
 	};
 
+    // compile-time string comparison for attribute names
+    constexpr bool equal_names(const char *l, const char *r)
+    {
+        for (; *l && *r; ++l, ++r)
+            if (*l != *r)
+                return false;
+        return *l == *r;
+    }
+
+    // attribute "member" of the sequence "seq" within a buffer
+    template <size_t seq, size_t member, class Attr>
+    struct layout_member
+    {
+        constexpr static size_t seq_indx = seq;
+        constexpr static size_t member_indx = member;
+        using type = Attr;
+    };
+
+    template <size_t seq, class AttrCompound,
+        class = decltype(std::make_index_sequence<std::tuple_size_v<AttrCompound>>())>
+    struct sequence_members;
+
+    template <size_t seq, class ... Attr, size_t ... member>
+    struct sequence_members<seq, compound<Attr...>, std::index_sequence<member...>>
+    {
+        using type = std::tuple<layout_member<seq, member, Attr>...>;
+    };
+
+    /*
+    Matches VAO attributes to the attributes of buffer's sequences.
+    Priority of a match:
+    3 - both attributes are named and names are equal (named attributes with different names never match);
+    2 - same types;
+    1 - equivalent types;
+    Each buffer attribute is used at most once.
+    */
+    template <class VAOAttribs, class BufferAttribs,
+        class = decltype(std::make_index_sequence<std::tuple_size_v<BufferAttribs>>())>
+    struct layout_matching;
+
+    template <class ... VAttr, class ... BAttr, size_t ... seq>
+    struct layout_matching<std::tuple<VAttr...>, std::tuple<BAttr...>, std::index_sequence<seq...>>
+    {
+        // flat list of buffer attributes
+        using members = decltype(std::tuple_cat(
+            std::declval<typename sequence_members<seq, wrap_attr_t<BAttr>>::type>()...));
+
+        constexpr static size_t attr_count = sizeof...(VAttr);
+        constexpr static size_t member_count = std::tuple_size_v<members>;
+
+        template <class V, class B>
+        constexpr static int rank()
+        {
+            if constexpr (has_name_v<V> && has_name_v<B>)
+                return equal_names(variable_traits_name<V>, variable_traits_name<B>) ? 3 : 0;
+            else if constexpr (std::is_same_v<variable_traits_type<V>, variable_traits_type<B>>)
+                return 2;
+            else if constexpr (is_equivalent_v<variable_traits_type<V>, variable_traits_type<B>>)
+                return 1;
+            else
+                return 0;
+        }
+
+        template <class V, class ... Member>
+        constexpr static std::array<int, member_count> ranks_row(std::tuple<Member...>*)
+        {
+            return { rank<V, typename Member::type>()... };
+        }
+
+        // index of the member for each VAO attribute, member_count if not matched
+        constexpr static std::array<size_t, attr_count> match()
+        {
+            const std::array<std::array<int, member_count>, attr_count> ranks{
+                ranks_row<VAttr>((members*)nullptr)... };
+
+            std::array<size_t, attr_count> matched{};
+            bool used[member_count]{};
+
+            for (size_t i = 0; i != attr_count; ++i)
+                matched[i] = member_count;
+
+            for (int r = 3; r != 0; --r)
+                for (size_t i = 0; i != attr_count; ++i)
+                {
+                    if (matched[i] != member_count)
+                        continue;
+
+                    for (size_t m = 0; m != member_count; ++m)
+                        if (!used[m] && ranks[i][m] == r)
+                        {
+                            matched[i] = m;
+                            used[m] = true;
+                            break;
+                        }
+                }
+
+            return matched;
+        }
+
+        constexpr static std::array<size_t, attr_count> matched = match();
+
+        constexpr static bool all_matched()
+        {
+            for (size_t i = 0; i != attr_count; ++i)
+                if (matched[i] == member_count)
+                    return false;
+            return true;
+        }
+
+        template <size_t i>
+        using member_i = std::tuple_element_t<matched[i], members>;
+    };
+
+    template <class ... VAttr, class ... BAttr, size_t ... indx>
+    void bind_layout_(VAO<VAttr...>& vao, Buffer<BAttr...>& buffer,
+        std::index_sequence<indx...>, bool normalize)
+    {
+        using matching = layout_matching<std::tuple<VAttr...>, std::tuple<BAttr...>>;
+
+        static_assert(matching::all_matched(),
+            "Buffer does not provide all the attributes of the VAO!");
+
+        (vao.AttributePointer(tag_s<indx>(),
+            buffer.SeqN(tag_s<matching::template member_i<indx>::seq_indx>())
+                (tag_s<matching::template member_i<indx>::member_indx>()),
+            normalize), ...);
+
+        (vao.EnablePointer(tag_s<indx>()), ...);
+    }
+
+    /*
+    Sets up all VAO attributes from the buffer's sequences.
+    Attributes are matched at compile-time (see layout_matching),
+    already enabled arrays are not enabled again.
+    */
+    template <class ... VAttr, class ... BAttr>
+    void bind_layout(VAO<VAttr...>& vao, Buffer<BAttr...>& buffer, bool normalize = false)
+    {
+        if (!vao.IsBound())
+            vao.Bind();
+
+        if (buffer.Bound() != BufferTarget::array)
+            buffer.Bind(BufferTarget::array);
+
+        bind_layout_(vao, buffer, std::index_sequence_for<VAttr...>(), normalize);
+    }
 
-}
\ No newline at end of file
+}
@@ -4,35 +4,19 @@
 
 using namespace glt;
 
-//template class MapStatus_<BufferTargetList>;
+thread_local Context* Context::current_ = nullptr;
+std::atomic<Context*> Context::retireTarget_{ nullptr };
 
-template <class>
-struct init_map;
-
-template <BufferTarget ... targets>
-struct init_map<std::integer_sequence<BufferTarget, targets...>>
+Context& Context::Default()
 {
-    operator std::map<BufferTarget, buffer_base*>() const
-    {
-        return { {targets, nullptr}... };
-    }
-};
-
-std::map<BufferTarget, buffer_base*> buffer_base::targets_{ init_map<BufferTargetList>() };
-
-vao_base* vao_base::active_vao_ = nullptr;
-program_base *program_base::active_prog_ = nullptr;
-
-std::array<texture_base*, TextureTargetList::size>
-    texture_base::active_textures_{ nullptr };
-
-std::map<FrameBufTarget, framebuffer_base*> framebuffer_base::bound_{
-	{FrameBufTarget::draw, nullptr},
-{FrameBufTarget::framebuffer, nullptr},
-{FrameBufTarget::read, nullptr}
-};
+    static Context context;
+    return context;
+}
 
-renderbuffer_base * renderbuffer_base::bound_ = nullptr;
+gl_state& gl_state::Current()
+{
+    return Context::Current().State();
+}
 
 bool glt::AssertGL()
 {
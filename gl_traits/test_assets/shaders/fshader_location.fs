@@ -0,0 +1,13 @@
+#version 430 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+// location is written to glt_Common.h by glt_parser
+layout (location = 5) uniform float brightness;
+uniform sampler2D texture1;
+
+void main()
+{
+	FragColor = texture(texture1, TexCoord) * brightness;
+}
\ No newline at end of file
@@ -4,8 +4,13 @@
 
 /* This unit checks for correctness: 
 - handle allocations
+- handle allocations from a pool
+- deferred deletion of handles
+- shared handles
 */
 
+#include <thread>
+
 template <typename T>
 int CheckHandle()
 {
@@ -29,6 +34,149 @@ int CheckHandles()
     return (CheckHandle<T>() + ...);
 }
 
+// names are generated and deleted in batches
+int CheckPool()
+{
+    glt::Context context;
+    context.MakeCurrent();
+    context.EnablePool<glt::BufferTarget>(16, 8);
+
+    glt::HandlePool<glt::BufferTarget> *pool = context.Pool<glt::BufferTarget>();
+
+    int res = 0;
+    {
+        std::vector<glt::HandleBuffer> handles;
+        for (int i = 0; i != 10; ++i)
+            handles.push_back(glt::Allocator::Allocate(glt::BufferTarget()));
+
+        if (pool->GenerateCalls() != 1 || pool->Available() != 6)
+            res = 1;
+    }
+
+    // 8 names deleted with the first batch
+    if (pool->DeleteCalls() != 1 || pool->Pending() != 2)
+        res = 1;
+
+    context.FlushPools();
+    if (pool->DeleteCalls() != 2 || pool->Pending())
+        res = 1;
+
+    context.DisablePool<glt::BufferTarget>();
+    glt::Context::ReleaseCurrent();
+
+    return res;
+}
+
+// handles are deleted after the frame fence has signalled
+int CheckRetire()
+{
+    glt::Context context;
+    context.MakeCurrent();
+    context.EnableDeferredDeletion();
+
+    GLuint raw = 0,
+        rawOther = 0;
+    {
+        glt::Buffer<glm::vec3> buffer, other;
+        buffer.Bind(glt::BufferTarget::array);
+        raw = glt::handle_accessor(buffer.Handle());
+        other.Bind(glt::BufferTarget::array);
+        rawOther = glt::handle_accessor(other.Handle());
+        other.UnBind();
+
+        // destroyed on a thread without OpenGL context
+        std::thread([buf = std::move(other)]() {}).join();
+    }
+
+    int res = 0;
+    if (!glIsBuffer(raw) || !glIsBuffer(rawOther))
+        res = 1;
+
+    context.EndFrame();
+    context.DisableDeferredDeletion();
+
+    if (glIsBuffer(raw) || glIsBuffer(rawOther))
+        res = 1;
+
+    glt::Context::ReleaseCurrent();
+    return res;
+}
+
+// object is deleted with the last reference
+int CheckShared()
+{
+    int res = 0;
+
+    GLuint raw = 0;
+    {
+        glt::SharedHandle<glt::BufferTarget> shared = glt::Allocator::Allocate(glt::BufferTarget());
+        raw = glt::handle_accessor(shared);
+        glBindBuffer(GL_ARRAY_BUFFER, raw);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if (shared.UseCount() != 1)
+            res = 1;
+
+        {
+            glt::SharedHandle<glt::BufferTarget> copy = shared;
+            if (shared.UseCount() != 2 || copy != raw)
+                res = 1;
+        }
+
+        if (shared.UseCount() != 1 || !glIsBuffer(raw))
+            res = 1;
+    }
+
+    if (glIsBuffer(raw))
+        res = 1;
+
+    // concurrent first copies share a single counter
+    {
+        glt::SharedHandle<glt::BufferTarget> shared = glt::Allocator::Allocate(glt::BufferTarget());
+        raw = glt::handle_accessor(shared);
+        glBindBuffer(GL_ARRAY_BUFFER, raw);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        auto copy = [&shared]()
+        {
+            for (int i = 0; i != 1000; ++i)
+                glt::SharedHandle<glt::BufferTarget> c = shared;
+        };
+
+        std::thread t1(copy),
+            t2(copy);
+        t1.join();
+        t2.join();
+
+        if (shared.UseCount() != 1 || !glIsBuffer(raw))
+            res = 1;
+    }
+
+    if (glIsBuffer(raw))
+        res = 1;
+
+    {
+        glt::Texture2Drgba texture;
+        texture.Bind();
+        texture.SetImage(0, 4, 4);
+        raw = glt::handle_accessor(texture.Handle());
+
+        glt::Texture2Drgba shared = texture.Share();
+        {
+            glt::Texture2Drgba moved = std::move(texture);
+        }
+
+        if (shared.UseCount() != 1 || !glIsTexture(raw) ||
+            glt::handle_accessor(shared.Handle()) != (GLint)raw)
+            res = 1;
+    }
+
+    if (glIsTexture(raw))
+        res = 1;
+
+    return res;
+}
+
 int main()
 {
     SmartGLFW sglfw{4, 4};
@@ -59,5 +207,5 @@ int main()
 		glt::SamplerTarget,
 		glt::ShaderTarget,
 		glt::ProgramTarget
-	>();
+	>() + CheckPool() + CheckRetire() + CheckShared();
 }
\ No newline at end of file
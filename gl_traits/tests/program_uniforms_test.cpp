@@ -4,6 +4,7 @@
 
 #include <streambuf>
 #include <fstream>
+#include <thread>
 
 #include "glt_Common.h"
 #include "glt_CommonValidate.h"
@@ -14,11 +15,40 @@ using unif_collect = glt::uniform_collection<std::tuple<model_mat4,
 	texture1_sampler2D,
 	texture2_sampler2D>>;
 
+// brightness is declared with layout (location = 5) in fshader_location.fs
+using unif_location = glt::uniform_collection<std::tuple<brightness_float,
+	texture1_sampler2D>>;
+
+static_assert(glt::variable_traits_location<brightness_float> == 5);
+static_assert(glt::variable_traits_location<texture1_sampler2D> == -1);
+
+// counts the calls made through the loaded glUniformMatrix4fv
+PFNGLUNIFORMMATRIX4FVPROC uniformMatrix4fv = nullptr;
+size_t uniformMatrix4fvCalls = 0;
+
+void APIENTRY CountUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose,
+    const GLfloat *value)
+{
+    ++uniformMatrix4fvCalls;
+    uniformMatrix4fv(location, count, transpose, value);
+}
+
+// counts the locations queried by name
+PFNGLGETUNIFORMLOCATIONPROC getUniformLocation = nullptr;
+size_t getUniformLocationCalls = 0;
+
+GLint APIENTRY CountGetUniformLocation(GLuint program, const GLchar *name)
+{
+    ++getUniformLocationCalls;
+    return getUniformLocation(program, name);
+}
+
 int main(int argc, const char** argv)
 {
 	fsys::path path = fsys::path(argv[0]).parent_path();
 
-	SmartGLFW glfw{ 3, 3 };
+	// explicit uniform locations require OpenGL 4.3
+	SmartGLFW glfw{ 4, 3 };
 	SmartGLFWwindow window{ SCR_WIDTH, SCR_HEIGHT, "test program and uniforms" };
 
 	glfw.MakeContextCurrent(window);
@@ -89,5 +119,119 @@ int main(int argc, const char** argv)
         test_res |= 10;
     assert(!test_res && "texture2_sampler2D get failed!");
 
+    // shadow values
+    auto& model = prog.Uniform(glt::tag_t<model_mat4>());
+
+    constexpr glm::mat4 m2{ 7 };
+
+    // the redundant value is not set
+    uniformMatrix4fv = glUniformMatrix4fv;
+    glUniformMatrix4fv = CountUniformMatrix4fv;
+    model.Set(m2);
+    model.Set(m2);
+    glUniformMatrix4fv = uniformMatrix4fv;
+
+    if (uniformMatrix4fvCalls != 1)
+        test_res |= 16;
+
+    glm::mat4 queried{};
+    model.Query(queried);
+    if (queried != m2 || model.Get() != m2)
+        test_res |= 16;
+    assert(!test_res && "Uniform shadow value differs from OpenGL!");
+
+    // values set bypassing the Uniform are not shadowed
+    glUniformMatrix4fv(glGetUniformLocation(glt::handle_accessor(prog.Handle()), "model"),
+        1, GL_FALSE, &m[0][0]);
+
+    model.Query(queried);
+    if (queried != m || model.Get() != m2)
+        test_res |= 32;
+    assert(!test_res && "Uniform shadow value has been queried!");
+
+    // explicit location is used without querying it
+    fileSource.close();
+    fileSource.open(fsys::path(path).append("shaders/fshader_location.fs"), std::fstream::in);
+
+    std::string fLocationSource{ std::istreambuf_iterator<char>(fileSource),
+        std::istreambuf_iterator<char>() };
+
+    glt::FragmentShader fLocation{ fLocationSource };
+
+    getUniformLocation = glGetUniformLocation;
+    glGetUniformLocation = CountGetUniformLocation;
+
+    glt::Program<VAO_vshader, unif_location>
+        progLocation{ glt::Allocator::Allocate(glt::ProgramTarget()), vShader, fLocation };
+
+    glGetUniformLocation = getUniformLocation;
+
+    // only texture1 is queried
+    if (getUniformLocationCalls != 1)
+        test_res |= 64;
+    assert(!test_res && "Explicit uniform location has been queried!");
+
+    progLocation.Use();
+
+    float brightness = 0.5f,
+        brightnessQueried = 0.f;
+    progLocation.Set(glt::glsl_cast<brightness_float>(brightness));
+
+    GLuint locationHandle = glt::handle_accessor(progLocation.Handle());
+    glGetUniformfv(locationHandle, 5, &brightnessQueried);
+    if (glGetUniformLocation(locationHandle, "brightness") != 5 || brightnessQueried != brightness)
+        test_res |= 512;
+    assert(!test_res && "Explicit uniform location failed!");
+
+    // program binary cache, the second link loads the binary
+    fsys::path cachePath = fsys::path(path).append("program_cache");
+    fsys::remove_all(cachePath);
+
+    glt::ProgramBinaryCache cache{ cachePath };
+    for (size_t i = 0; i != 2; ++i)
+    {
+        glt::Program<VAO_vshader, unif_collect> cached;
+        if (!cached.Link(cache, vSource, fSource))
+            test_res |= 128;
+    }
+
+    if (glt::ProgramBinaryCache::Supported() && (cache.Misses() != 1 || cache.Hits() != 1))
+        test_res |= 128;
+
+    // corrupt length of the binary is a miss, the program is linked from the sources
+    if (glt::ProgramBinaryCache::Supported())
+    {
+        for (const fsys::directory_entry& entry : fsys::directory_iterator(cachePath))
+        {
+            std::fstream file{ entry.path(), std::ios::binary | std::ios::in | std::ios::out };
+
+            // magic, format and key precede the length
+            std::uint64_t length = ~0ull;
+            file.seekp(16);
+            file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        }
+
+        glt::Program<VAO_vshader, unif_collect> relinked;
+        if (!relinked.Link(cache, vSource, fSource) || cache.Misses() != 2 || cache.Hits() != 1)
+            test_res |= 128;
+    }
+    assert(!test_res && "Program binary cache failed!");
+
+    // asynchronous compilation and link
+    glt::shader_traits::SetCompilerThreads();
+
+    glt::VertexShader vAsync{ vSource, glt::async_tag() };
+    glt::FragmentShader fAsync{ fSource, glt::async_tag() };
+
+    glt::Program<VAO_vshader, unif_collect> progAsync;
+    progAsync.LinkAsync(vAsync, fAsync);
+
+    while (!progAsync.IsReady())
+        std::this_thread::yield();
+
+    if (!progAsync.Wait() || !vAsync.IsValid() || !fAsync.IsValid())
+        test_res |= 256;
+    assert(!test_res && "Asynchronous link failed!");
+
     return test_res;
 }
\ No newline at end of file
@@ -0,0 +1,158 @@
+/* render_queue_test.cpp
+
+This module tests the sorted render queue:
+
+- keys are sorted by program, VAO, texture and depth, equal keys keep the submission order: flag 1;
+- draws are grouped by program and VAO when executed: flag 2;
+- command list recorded on another thread is replayed with redundant bindings skipped: flag 4;
+- uniforms set by a replayed command list keep their shadow values: flag 8;
+
+return code is a bitmask of flags set for each failed case;
+*/
+
+#include "gl_traits.hpp"
+#include "helpers.h"
+
+#include "glt_Common.h"
+
+#include <fstream>
+#include <streambuf>
+#include <thread>
+
+int main(int argc, const char** argv)
+{
+	fsys::path path = fsys::path(argv[0]).parent_path();
+
+	SmartGLFW glfw{ 3, 3 };
+	SmartGLFWwindow window{ SCR_WIDTH, SCR_HEIGHT, "render queue test" };
+
+	glfw.MakeContextCurrent(window);
+	glt::LoadOpenGL(glfw.GetOpenGLLoader());
+
+	int retMask = 0;
+
+	// sorting
+	{
+		glt::RenderQueue queue;
+
+		glt::DrawCommand draw;
+		draw.vao = 1;
+		for (GLuint i = 0; i != 16; ++i)
+		{
+			draw.program = 1 + i % 3;
+			draw.first = (GLint)i;
+			queue.Submit(draw, (i % 4) / 4.f);
+		}
+
+		queue.Sort();
+
+		for (size_t i = 1; i != queue.Size(); ++i)
+			if (queue.Key(i - 1) > queue.Key(i) ||
+				(queue.Key(i - 1) == queue.Key(i) && queue[i - 1].first > queue[i].first))
+				retMask |= 1;
+
+		if (queue[0].program != 1 || queue[queue.Size() - 1].program != 3)
+			retMask |= 1;
+		assert(!retMask && "Render queue is not sorted!");
+	}
+
+	// execution
+	{
+		std::fstream fileSource{ fsys::path(path).append("shaders/vshader.vs"), std::fstream::in };
+		std::string vSource{ std::istreambuf_iterator<char>(fileSource),
+			std::istreambuf_iterator<char>() };
+
+		fileSource.close();
+		fileSource.open(fsys::path(path).append("shaders/fshader.fs"), std::fstream::in);
+		std::string fSource{ std::istreambuf_iterator<char>(fileSource),
+			std::istreambuf_iterator<char>() };
+
+		glt::VertexShader vShader{ vSource };
+		glt::FragmentShader fShader{ fSource };
+
+		using program_type = glt::Program<VAO_vshader, glt::uniform_collection<std::tuple<model_mat4,
+			view_mat4, projection_mat4, texture1_sampler2D, texture2_sampler2D>>>;
+		program_type prog1{ glt::Allocator::Allocate(glt::ProgramTarget()), vShader, fShader },
+			prog2{ glt::Allocator::Allocate(glt::ProgramTarget()), vShader, fShader };
+
+		VAO_vshader vao1,
+			vao2;
+
+		glt::RenderQueue queue;
+		for (size_t i = 0; i != 8; ++i)
+		{
+			glt::DrawCommand draw;
+			draw.program = glt::handle_accessor(i % 2 ? prog1.Handle() : prog2.Handle());
+			draw.vao = glt::handle_accessor(i % 4 < 2 ? vao1.Handle() : vao2.Handle());
+			draw.count = 3;
+			queue.Submit(draw);
+		}
+
+		glt::gl_state& state = glt::gl_state::Current();
+		state.UseProgram(0);
+		state.BindVertexArray(0);
+		state.ResetCounters();
+
+		queue.Execute();
+
+		if (state.Counter(glt::StateGroup::program).issued != 2 ||
+			state.Counter(glt::StateGroup::vao).issued != 4 ||
+			!glt::AssertGL())
+			retMask |= 2;
+		assert(!retMask && "Render queue draws are not grouped!");
+
+		state.UseProgram(0);
+		state.BindVertexArray(0);
+
+		// command list
+		GLuint program = glt::handle_accessor(prog1.Handle()),
+			vao = glt::handle_accessor(vao1.Handle());
+
+		auto& model = prog1.Uniform(glt::tag_t<model_mat4>());
+		auto& texture1 = prog1.Uniform(glt::tag_t<texture1_sampler2D>());
+
+		prog1.Use();
+		texture1.Set(0);
+		state.UseProgram(0);
+
+		glt::CommandList list;
+		std::thread recorder{ [&]()
+		{
+
+			for (size_t i = 0; i != 4; ++i)
+			{
+				list.UseProgram(program);
+				list.BindVertexArray(vao);
+				list.SetUniform(model, glm::mat4(1.f));
+				list.SetUniform(texture1, (int)i);
+				list.DrawArrays(glt::RenderMode::triangles, 0, 3);
+			}
+		} };
+		recorder.join();
+
+		state.ResetCounters();
+		list.Replay(state);
+
+		if (list.Commands() != 20 ||
+			state.Counter(glt::StateGroup::program).issued != 1 ||
+			state.Counter(glt::StateGroup::program).elided != 3 ||
+			state.Counter(glt::StateGroup::vao).issued != 1 ||
+			!glt::AssertGL())
+			retMask |= 4;
+		assert(!(retMask & 4) && "Command list is not replayed correctly!");
+
+		// the last replayed value is shadowed, thus setting the previous one is not skipped
+		texture1.Set(0);
+
+		GLint texture1Value = -1;
+		glGetUniformiv(program, glGetUniformLocation(program, "texture1"), &texture1Value);
+		if (texture1.Get() != 0 || texture1Value != 0)
+			retMask |= 8;
+		assert(!(retMask & 8) && "Uniform shadow value is stale after replay!");
+
+		state.UseProgram(0);
+		state.BindVertexArray(0);
+	}
+
+	return retMask;
+}
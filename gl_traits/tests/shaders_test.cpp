@@ -28,9 +28,21 @@ int main(int argc, const char *argv[])
 	static_assert(glt::has_type_v<VAOaPos_vec3>);
 	static_assert(sizeof(aPos_vec3) == sizeof(VAOaPos_vec3));
 
+	// stage interfaces of program pipelines
+	using VertexStage = glt::StageProgram<glt::Shader<glt::ShaderTarget::vertex,
+		VarsIn_vshader_vert, VarsOut_vshader_vert>>;
+	using FragmentStage = glt::StageProgram<glt::Shader<glt::ShaderTarget::fragment,
+		VarsIn_fshader_frag, VarsOut_fshader_frag>>;
+
+	static_assert(glt::tuple_includes_v<FragmentStage::vars_in, VertexStage::vars_out>);
+	static_assert(!glt::tuple_includes_v<VertexStage::vars_in, FragmentStage::vars_out>);
+	static_assert(std::is_constructible_v<glt::ProgramPipeline<VertexStage, FragmentStage>,
+		const VertexStage&, const FragmentStage&>);
+
 	std::filesystem::path exePath{ argv[0] };
 
-	SmartGLFW glfw{ 3, 3 };
+	// separable programs and pipelines require OpenGL 4.1
+	SmartGLFW glfw{ 4, 1 };
 	SmartGLFWwindow window{ SCR_WIDTH, SCR_HEIGHT, "Test shaders" };
 
 	glfw.MakeContextCurrent(window);
@@ -56,6 +68,27 @@ int main(int argc, const char *argv[])
 
 	glt::identical_sets_v<std::tuple<>, std::tuple<>>;
 
+	// shader variants
+	if (glt::ShaderDefines{ { "A", "1" }, { "B", "2" } }.Key() !=
+		glt::ShaderDefines{ { "B", "2" }, { "A", "1" } }.Key())
+	{
+		std::cerr << "Shader defines key depends on the order of definition!" << std::endl;
+		return -1;
+	}
+
+	glt::ShaderVariants<glt::VertexShader> variants{ vertexSource };
+	variants.Precompile({ glt::ShaderDefines{ { "VARIANT", "2" } } });
+
+	auto variant = variants.Get({ { "VARIANT", "1" } });
+	if (variant != variants.Get({ { "VARIANT", "1" } }) ||
+		variant == variants.Get({ { "VARIANT", "2" } }) ||
+		variants.Compiles() != 2 || !variant->IsValid() ||
+		!variants.Get({ { "VARIANT", "2" } })->IsValid())
+	{
+		std::cerr << "Shader variants are not shared!" << std::endl;
+		return -1;
+	}
+
     VAO_vshader vs{};
 
     //vs.EnablePointer(glt::tag_s<0>());
@@ -94,5 +127,44 @@ int main(int argc, const char *argv[])
     sizeof(glt::buffer_base);
     sizeof(glt::Buffer<glm::vec3>);
 
+	// stage programs linked separately and combined in a pipeline
+	f.close();
+	f.open(exePath.parent_path().append("fshader.fs"), std::fstream::in);
+
+	std::string fragmentSource{ std::istreambuf_iterator<char>(f),
+	std::istreambuf_iterator<char>() };
+
+	VertexStage::shader vStageShader{ vertexSource };
+	FragmentStage::shader fStageShader{ fragmentSource };
+
+	VertexStage vStage{ glt::Allocator::Allocate(glt::ProgramTarget()), vStageShader };
+	FragmentStage fStage{ glt::Allocator::Allocate(glt::ProgramTarget()), fStageShader };
+
+	if (!vStage.Linked() || !fStage.Linked())
+	{
+		std::cerr << "Failed to link separable programs!" << std::endl;
+		return -1;
+	}
+
+	GLuint pipelineName = 0;
+	{
+		glt::ProgramPipeline<VertexStage, FragmentStage> pipeline{ vStage, fStage };
+		pipelineName = glt::handle_accessor(pipeline.Handle());
+
+		pipeline.Bind();
+		if (!pipeline.IsBound() || !pipeline.Validate())
+		{
+			std::cerr << "Program pipeline is not valid!" << std::endl;
+			return -1;
+		}
+	}
+
+	// deleted pipeline is unbound
+	if (glt::gl_state::Current().ProgramPipeline() == pipelineName)
+	{
+		std::cerr << "Deleted program pipeline is cached as bound!" << std::endl;
+		return -1;
+	}
+
 	return 0;
 }
\ No newline at end of file
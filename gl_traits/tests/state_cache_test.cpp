@@ -0,0 +1,165 @@
+/* state_cache_test.cpp
+
+This module tests the GL state cache:
+
+- redundant buffer bindings are elided: flag 1;
+- cache is consistent with glGet after binding through the wrappers: flag 2;
+- texture units are tracked separately: flag 4;
+- deleted objects are removed from the cache: flag 8;
+- capabilities: flag 16;
+- verify policy detects state changed bypassing the cache: flag 32 (GLT_STATE_POLICY=VERIFY);
+
+return code is a bitmask of flags set for each failed case;
+*/
+
+#include "gl_traits.hpp"
+#include "helpers.h"
+
+#include "glt_Common.h"
+
+GLint GetInteger(GLenum param)
+{
+	GLint val = 0;
+	glGetIntegerv(param, &val);
+	return val;
+}
+
+void test_buffers(int& mask)
+{
+	glt::gl_state& state = glt::gl_state::Current();
+
+	glt::Buffer<glm::vec3> buffer;
+	buffer.Bind(glt::BufferTarget::array);
+
+	state.ResetCounters();
+	for (int i = 0; i != 10; ++i)
+		buffer.Bind(glt::BufferTarget::array);
+
+	const glt::state_counter& counter = state.Counter(glt::StateGroup::buffer);
+	if (counter.issued || counter.elided != 10)
+		mask |= 1;
+
+	if (GetInteger(GL_ARRAY_BUFFER_BINDING) != (GLint)glt::handle_accessor(buffer.Handle()) ||
+		!buffer.IsBound())
+		mask |= 2;
+
+	buffer.UnBind();
+	if (GetInteger(GL_ARRAY_BUFFER_BINDING) || buffer.IsBound())
+		mask |= 2;
+}
+
+void test_textures(int& mask)
+{
+	glt::gl_state& state = glt::gl_state::Current();
+
+	glt::Texture2Drgba tex0, tex1;
+	tex0.Bind(0);
+	tex1.Bind(1);
+
+	if (state.Texture(0, glt::TextureTarget::texture_2d) != (GLuint)glt::handle_accessor(tex0.Handle()) ||
+		state.Texture(1, glt::TextureTarget::texture_2d) != (GLuint)glt::handle_accessor(tex1.Handle()) ||
+		GetInteger(GL_ACTIVE_TEXTURE) != GL_TEXTURE1 ||
+		GetInteger(GL_TEXTURE_BINDING_2D) != (GLint)glt::handle_accessor(tex1.Handle()))
+		mask |= 4;
+
+	state.ResetCounters();
+
+	// already bound, active unit is not switched
+	state.BindTexture(0, glt::TextureTarget::texture_2d, glt::handle_accessor(tex0.Handle()));
+	if (state.Counter(glt::StateGroup::active_texture).issued ||
+		state.ActiveUnit() != 1)
+		mask |= 4;
+
+	if (!tex0.IsBound(0) || tex0.IsBound(1))
+		mask |= 4;
+}
+
+void test_deleted(int& mask)
+{
+	glt::gl_state& state = glt::gl_state::Current();
+
+	GLuint raw = 0;
+	{
+		glt::Buffer<glm::vec3> buffer;
+		buffer.Bind(glt::BufferTarget::array);
+		raw = glt::handle_accessor(buffer.Handle());
+	}
+
+	if (state.Buffer(glt::BufferTarget::array) == raw ||
+		GetInteger(GL_ARRAY_BUFFER_BINDING))
+		mask |= 8;
+}
+
+void test_capabilities(int& mask)
+{
+	glt::gl_state& state = glt::gl_state::Current();
+	state.ResetCounters();
+
+	glt::Enable(glt::Capability::depth_test);
+	glt::Enable(glt::Capability::depth_test);
+
+	if (!glIsEnabled(GL_DEPTH_TEST) ||
+		state.Counter(glt::StateGroup::capability).elided != 1)
+		mask |= 16;
+
+	glt::Disable(glt::Capability::depth_test);
+	if (glIsEnabled(GL_DEPTH_TEST) || state.IsEnabled(glt::Capability::depth_test))
+		mask |= 16;
+
+	// enabled bypassing the cache, unknown once invalidated
+	glEnable(GL_DEPTH_TEST);
+	state.Invalidate();
+	if (!state.IsEnabled(glt::Capability::depth_test))
+		mask |= 16;
+
+	glt::Disable(glt::Capability::depth_test);
+	if (glIsEnabled(GL_DEPTH_TEST) || state.IsEnabled(glt::Capability::depth_test))
+		mask |= 16;
+}
+
+void test_verify(int& mask)
+{
+	glt::gl_state& state = glt::gl_state::Current();
+
+	glt::Buffer<glm::vec3> buffer;
+	buffer.Bind(glt::BufferTarget::array);
+
+	size_t mismatches = glt::state_mismatches();
+	if (!buffer.IsBound() || glt::state_mismatches() != mismatches)
+		mask |= 32;
+
+	// bypassing the cache
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	buffer.IsBound();
+	if constexpr (glt::state_policy == glt::StatePolicy::verify)
+		if (glt::state_mismatches() != mismatches + 1)
+			mask |= 32;
+
+	state.Invalidate();
+	if (state.Buffer(glt::BufferTarget::array) != glt::gl_state::unknown)
+		mask |= 32;
+}
+
+int main()
+{
+	SmartGLFW glfw{ 4, 5 };
+	SmartGLFWwindow window{ SCR_WIDTH, SCR_HEIGHT, "state cache test" };
+	glfw.MakeContextCurrent(window);
+
+	glt::LoadOpenGL(glfw.GetOpenGLLoader());
+
+	int retMask = 0;
+
+	test_buffers(retMask);
+	test_textures(retMask);
+	test_deleted(retMask);
+	test_capabilities(retMask);
+
+	// no mismatches before the cache is bypassed deliberately
+	if (glt::state_mismatches())
+		retMask |= 32;
+
+	test_verify(retMask);
+
+	return retMask;
+}
@@ -1,6 +1,8 @@
 ﻿
 #include "gl_traits.hpp"
 #include "helpers.h"
+#include "block_compression.h"
+#include "mip_generation.h"
 
 
 template <class TexTarSeq>
@@ -17,7 +19,7 @@ int main()
 
     constexpr auto& targets = get_tar_indx<glt::TextureTargetList>::targets;
 
-    SmartGLFW glfw{ 3, 3 };
+    SmartGLFW glfw{ 4, 4 };
     SmartGLFWwindow window{ SCR_WIDTH, SCR_HEIGHT, "Testing textures" };
 
     glfw.MakeContextCurrent(window);
@@ -34,10 +36,345 @@ int main()
 
 	GLenum error = glGetError();
 
+	int retMask = 0;
+
+	// immutable storage with full mip chain
+	{
+		glt::Texture2D<glt::TexInternFormat::rgba8> texStorage;
+		texStorage.Bind();
+		texStorage.SetStorage(0, 256, 64);
+
+		GLint immutable = GL_FALSE,
+			levels = 0;
+		glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_FORMAT, &immutable);
+		glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+
+		if (!immutable || levels != 9 ||
+			!texStorage.Immutable() || texStorage.Levels() != 9 ||
+			!glt::AssertGL())
+			retMask |= 1;
+		assert(!retMask && "Immutable texture storage is not allocated!");
+
+		texStorage.UnBind();
+	}
+
+	// upload sourced from the pixel_unpack ring
+	{
+		std::vector<GLuint> pixels(64 * 64, 0xFF00FF00);
+
+		glt::PixelUploadRing ring{ 3 * pixels.size() * sizeof(GLuint) };
+
+		glt::Texture2D<glt::TexInternFormat::rgba8> texUpload;
+		texUpload.Bind();
+		texUpload.SetStorage(1, 64, 64);
+
+		ring.Bind();
+		for (size_t i = 0; i != 4; ++i)
+		{
+			texUpload.SubImage(0, 64, 64, glt::TexFormat::rgba, glt::TexType::unsigned_byte,
+				ring.Write(pixels.data(), pixels.size() * sizeof(GLuint)));
+			ring.Fence();
+		}
+		ring.UnBind();
+
+		std::vector<GLuint> read(pixels.size());
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, read.data());
+
+		if (read != pixels || !glt::AssertGL())
+			retMask |= 2;
+		assert(!(retMask & 2) && "Texture is not uploaded from the pixel_unpack ring!");
+
+		texUpload.UnBind();
+	}
+
+	// sizes not dividing the ring, regions wrapped onto are never in flight
+	{
+		glt::PixelUploadRing ring{ 350 };
+
+		const unsigned int widths[]{ 25, 10, 30, 15 };
+		std::vector<glt::Texture2D<glt::TexInternFormat::rgba8>> textures(12);
+
+		bool overwritten = false;
+
+		ring.Bind();
+		for (size_t i = 0; i != textures.size(); ++i)
+		{
+			unsigned int width = widths[i % 4];
+			std::vector<GLuint> pixels(width, (GLuint)i + 1);
+			size_t bytes = pixels.size() * sizeof(GLuint);
+
+			glt::PixelUploadRing::staging mem = ring.Allocate(bytes);
+			overwritten |= ring.InFlight(mem.offset, bytes);
+			std::memcpy(mem.data, pixels.data(), bytes);
+
+			textures[i].Bind();
+			textures[i].SetStorage(1, width, 1);
+			textures[i].SubImage(0, width, 1, glt::TexFormat::rgba, glt::TexType::unsigned_byte,
+				mem.offset);
+			ring.Fence();
+		}
+		ring.UnBind();
+
+		for (size_t i = 0; i != textures.size(); ++i)
+		{
+			std::vector<GLuint> read(widths[i % 4]);
+
+			textures[i].Bind();
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, read.data());
+
+			overwritten |= read != std::vector<GLuint>(read.size(), (GLuint)i + 1);
+		}
+		textures.back().UnBind();
+
+		if (overwritten || !glt::AssertGL())
+			retMask |= 512;
+		assert(!(retMask & 512) && "Upload ring overwrites regions in flight!");
+	}
+
+	// block compressed upload, checker of 0 and 255 is encoded without losses
+	{
+		std::vector<unsigned char> pixels(8 * 8);
+		for (size_t i = 0; i != pixels.size(); ++i)
+			pixels[i] = (i / 8 + i % 8) % 2 ? 255 : 0;
+
+		std::vector<unsigned char> blocks = CompressBlocks(BlockFormat::bc4, pixels.data(), 8, 8, 1);
+
+		glt::Texture2D<glt::TexInternFormat::compressed_red_rgtc1> texCompressed;
+		texCompressed.Bind();
+		texCompressed.SetStorage(1, 8, 8);
+		texCompressed.CompressedSubImage(0, 8, 8, blocks.data(), blocks.size());
+
+		std::vector<unsigned char> read(pixels.size());
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_UNSIGNED_BYTE, read.data());
+
+		if (blocks.size() != glt::compressed_image_bytes(glt::TexInternFormat::compressed_red_rgtc1, 8, 8) ||
+			read != pixels || !glt::AssertGL())
+			retMask |= 4;
+		assert(!(retMask & 4) && "Block compressed texture is not uploaded!");
+
+		texCompressed.UnBind();
+	}
+
+	// textures of the same size are packed to layers of an array
+	{
+		glt::TextureArrayPacker<glt::TexInternFormat::rgba8> packer;
+
+		// rows of 3x3 rgb pixels are 9 bytes
+		std::vector<unsigned char> rgb(3 * 3 * 3);
+		for (size_t i = 0; i != rgb.size(); ++i)
+			rgb[i] = (unsigned char)(i / 9 + 1);
+
+		glt::TextureLayer layers[4]{
+			packer.Add(4, 4, glt::TexFormat::rgba, glt::TexType::unsigned_byte,
+				std::vector<unsigned char>(4 * 4 * 4, 10)),
+			packer.Add(8, 8, glt::TexFormat::rgba, glt::TexType::unsigned_byte,
+				std::vector<unsigned char>(8 * 8 * 4, 20)),
+			packer.Add(4, 4, glt::TexFormat::rgba, glt::TexType::unsigned_byte,
+				std::vector<unsigned char>(4 * 4 * 4, 30)),
+			packer.Add(3, 3, glt::TexFormat::rgb, glt::TexType::unsigned_byte, rgb)
+		};
+
+		if (packer.Arrays() != 3 || packer.Layers(0) != 2 ||
+			layers[2].array != layers[0].array || layers[2].layer != 1)
+			retMask |= 8;
+
+		std::vector<glt::Texture2DArray<glt::TexInternFormat::rgba8>> arrays = packer.Build();
+
+		arrays[layers[2].array].Bind();
+
+		std::vector<unsigned char> read(4 * 4 * 4 * 2);
+		glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_UNSIGNED_BYTE, read.data());
+
+		arrays[layers[2].array].UnBind();
+		arrays[layers[3].array].Bind();
+
+		std::vector<unsigned char> readRgb(3 * 3 * 4);
+		glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_UNSIGNED_BYTE, readRgb.data());
+
+		bool rowsMatch = true;
+		for (size_t i = 0; i != 3 * 3; ++i)
+			rowsMatch &= readRgb[i * 4] == (unsigned char)(i / 3 + 1);
+
+		if (arrays.size() != 3 || read[0] != 10 || read.back() != 30 || !rowsMatch ||
+			arrays[0].Levels() != 3 || !glt::AssertGL())
+			retMask |= 8;
+		assert(!(retMask & 8) && "Textures are not packed to arrays!");
+
+		arrays[layers[3].array].UnBind();
+	}
+
+	// images are decoded by the workers, textures hold a placeholder until uploaded
+	{
+		glt::TextureLoader<glt::TexInternFormat::rgba> loader{ [](const std::string& source)
+		{
+			glt::DecodedImage decoded;
+			if (source == "missing")
+				return decoded;
+
+			decoded.width = decoded.height = 4;
+			decoded.pixels.assign(4 * 4 * 4, (unsigned char)source.size());
+			return decoded;
+		}, 2 };
+
+		glt::Texture2Drgba textures[3]{ loader.Load("a"), loader.Load("abc"), loader.Load("missing") };
+
+		// budget of a single image per call
+		for (int i = 0; i != 1000 && loader.Pending(); ++i)
+			if (!loader.Upload(1))
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		textures[1].Bind();
+
+		std::vector<unsigned char> read(4 * 4 * 4);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, read.data());
+
+		textures[1].UnBind();
+
+		// sizes of the uploaded images are shared with the returned textures
+		if (loader.Pending() || loader.Failed() != 1 ||
+			read != std::vector<unsigned char>(4 * 4 * 4, 3) ||
+			textures[1].Width() != 4 || textures[1].Height() != 4 || textures[1].Levels() != 3 ||
+			textures[2].Width() != 1 || !glt::AssertGL())
+			retMask |= 16;
+		assert(!(retMask & 16) && "Textures are not loaded asynchronously!");
+	}
+
+	// mip chain computed on the CPU instead of GenerateMipMap
+	{
+		std::vector<unsigned char> pixels(8 * 4 * 4);
+		for (size_t i = 0; i != pixels.size(); ++i)
+			pixels[i] = (unsigned char)(i * 7);
+
+		MipChain chain = GenerateMipChain(pixels.data(), 8, 4, 4, MipFilter::box);
+
+		glt::Texture2D<glt::TexInternFormat::rgba8> texMips;
+		texMips.Bind();
+		texMips.SetMipChain((unsigned int)chain.levels.size(), 8, 4, glt::TexFormat::rgba,
+			glt::TexType::unsigned_byte, chain.Pixels().data());
+
+		std::vector<unsigned char> read(2 * 1 * 4);
+		glGetTexImage(GL_TEXTURE_2D, 2, GL_RGBA, GL_UNSIGNED_BYTE, read.data());
+
+		if (chain.levels.size() != 4 || texMips.Levels() != 4 || read != chain.levels[2].pixels ||
+			!glt::AssertGL())
+			retMask |= 32;
+		assert(!(retMask & 32) && "Mip chain is not uploaded!");
+
+		texMips.UnBind();
+	}
+
+	// textures are deduplicated by contents and evicted by the least recent use
+	{
+		using Cache = glt::TextureCache<glt::TexInternFormat::rgba8>;
+		Cache cache{ 2 * 4 * 4 * 4 };
+
+		auto create = [](unsigned char value)
+		{
+			return [value]()
+			{
+				std::vector<unsigned char> pixels(4 * 4 * 4, value);
+
+				Cache::texture tex;
+				tex.Bind();
+				tex.SetImage(0, 4, 4);
+				tex.SubImage(0, 4, 4, glt::TexFormat::rgba, glt::TexType::unsigned_byte, pixels.data());
+				tex.UnBind();
+				return tex;
+			};
+		};
+
+		std::vector<unsigned char> images[3]{
+			std::vector<unsigned char>(4 * 4 * 4, 1),
+			std::vector<unsigned char>(4 * 4 * 4, 2),
+			std::vector<unsigned char>(4 * 4 * 4, 1)
+		};
+
+		glt::TextureKey keys[3];
+		for (size_t i = 0; i != 3; ++i)
+			keys[i] = Cache::Key(images[i].data(), images[i].size());
+
+		cache.Get(keys[0], create(1));
+		cache.Get(keys[1], create(2));
+
+		// same contents, thus the same texture
+		Cache::texture same = cache.Get(keys[2], create(1));
+
+		// exceeds the budget, the least recently used one is evicted
+		cache.Get(Cache::Key("other", 5), create(3));
+
+		if (cache.Hits() != 1 || cache.Misses() != 3 || cache.Evictions() != 1 ||
+			cache.Size() != 2 || cache.Bytes() != 2 * 4 * 4 * 4 ||
+			cache.Find(glt::TextureKey{ keys[0].hash, keys[0].size + 1 }).has_value() ||
+			cache.Find(keys[1]).has_value() || !cache.Find(keys[0]).has_value() || !glt::AssertGL())
+			retMask |= 64;
+		assert(!(retMask & 64) && "Textures are not cached!");
+	}
+
+	// placeholders of the loaded textures are cached, images are measured after upload
+	{
+		using Cache = glt::TextureCache<glt::TexInternFormat::rgba8>;
+		Cache cache{ 1 << 20 };
+
+		glt::TextureLoader<glt::TexInternFormat::rgba8> loader{ [](const std::string&)
+		{
+			glt::DecodedImage decoded;
+			decoded.width = decoded.height = 4;
+			decoded.pixels.assign(4 * 4 * 4, 1);
+			return decoded;
+		}, 1 };
+
+		cache.Get(Cache::Key("loaded", 6), [&]() { return loader.Load("loaded"); });
+		size_t placeholder = cache.Bytes();
+
+		for (int i = 0; i != 1000 && loader.Pending(); ++i)
+			if (!loader.Upload(1))
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		cache.Trim();
+
+		// 4x4, 2x2 and 1x1 levels
+		if (loader.Pending() || placeholder != 4 ||
+			cache.Bytes() != (4 * 4 + 2 * 2 + 1) * 4 || !glt::AssertGL())
+			retMask |= 256;
+		assert(!(retMask & 256) && "Loaded textures are not measured again!");
+	}
+
+	// textures of the units are sampled with shared sampler objects
+	{
+		glt::SamplerCache samplers;
+
+		glt::SamplerState nearestClamp;
+		nearestClamp.minFilter = glt::TexFilter::nearest;
+		nearestClamp.magFilter = glt::TexFilter::nearest;
+		nearestClamp.wrapS = nearestClamp.wrapT = glt::TexWrap::clamp_to_edge;
+
+		samplers.Bind(0, nearestClamp);
+		samplers.Bind(1, nearestClamp);
+		samplers.Bind(2, glt::SamplerState());
+
+		const glt::Sampler& sampler = samplers.Get(nearestClamp);
+
+		GLint bound = 0,
+			minFilter = 0;
+		glt::ActiveTexture(1);
+		glGetIntegerv(GL_SAMPLER_BINDING, &bound);
+		glGetSamplerParameteriv((GLuint)bound, GL_TEXTURE_MIN_FILTER, &minFilter);
+
+		if (samplers.Size() != 2 || samplers.Hits() != 2 || !sampler.IsBound(0) ||
+			(GLuint)bound != (GLuint)glt::handle_accessor(sampler.Handle()) || minFilter != GL_NEAREST ||
+			!glt::AssertGL())
+			retMask |= 128;
+		assert(!(retMask & 128) && "Samplers are not shared!");
+
+		for (GLuint unit = 0; unit != 3; ++unit)
+			glt::gl_state::Current().BindSampler(unit, 0);
+		glt::ActiveTexture(0);
+	}
+
 
     //tex2D.
 
    // glt::Texture2D<glt::TexInternFormat::rgba>::SetStorage
 
-    return 0;
+    return retMask;
 }
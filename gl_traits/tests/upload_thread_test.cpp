@@ -0,0 +1,88 @@
+/* upload_thread_test.cpp
+
+This module tests resource upload from a worker thread with a shared context:
+
+- buffer created and filled on the worker is usable on the render thread: flag 1;
+- texture created on the worker is usable on the render thread: flag 2;
+- binding state is tracked per context: flag 4;
+
+return code is a bitmask of flags set for each failed case;
+*/
+
+#include "gl_traits.hpp"
+#include "helpers.h"
+
+#include "glt_Common.h"
+
+#include <vector>
+
+int main()
+{
+	SmartGLFW glfw{ 4, 5 };
+	SmartGLFWwindow window{ SCR_WIDTH, SCR_HEIGHT, "upload thread test" };
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	SmartGLFWwindow uploadWindow{ 1, 1, "upload context", window };
+
+	glfw.MakeContextCurrent(window);
+	glt::LoadOpenGL(glfw.GetOpenGLLoader());
+
+	int retMask = 0;
+
+	using buffer_type = glt::Buffer<glm::vec3>;
+	std::vector<glm::vec3> vertices(100, glm::vec3(1.f, 2.f, 3.f));
+
+	glt::Texture2Drgba tex;
+	tex.Bind(0);
+
+	glt::gl_state *workerState = nullptr;
+
+	{
+		glt::UploadThread uploader{ [&]() { glfwMakeContextCurrent(uploadWindow); },
+			[]() { glfwMakeContextCurrent(nullptr); } };
+
+		std::future<buffer_type> buffer = uploader.Submit([&]()
+		{
+			buffer_type buf;
+			buf.Bind(glt::BufferTarget::array);
+			buf.AllocateMemory(vertices.size(), glt::BufUsage::static_draw);
+			buf().SubData(vertices.data(), vertices.size());
+
+			workerState = &glt::gl_state::Current();
+			return buf;
+		});
+
+		std::future<glt::Texture2Drgba> texture = uploader.Submit([]()
+		{
+			glt::Texture2Drgba texture;
+			texture.Bind();
+			texture.SetImage(0, 64, 64);
+			return texture;
+		});
+
+		buffer_type buf = buffer.get();
+		buf.Bind(glt::BufferTarget::array);
+
+		std::vector<glm::vec3> read(vertices.size());
+		glGetBufferSubData(GL_ARRAY_BUFFER, 0, read.size() * sizeof(glm::vec3), read.data());
+		if (read != vertices)
+			retMask |= 1;
+
+		glt::Texture2Drgba uploaded = texture.get();
+		uploaded.Bind(1);
+
+		GLint width = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+		if (width != 64)
+			retMask |= 2;
+	}
+
+	// render thread uses the default context, its bindings have not been changed by the worker
+	glt::gl_state& state = glt::gl_state::Current();
+	if (workerState == &state ||
+		&glt::Context::Current() != &glt::Context::Default() ||
+		state.Texture(0, glt::TextureTarget::texture_2d) != glt::handle_accessor(tex.Handle()))
+		retMask |= 4;
+
+	return retMask;
+}
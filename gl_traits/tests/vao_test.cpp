@@ -0,0 +1,235 @@
+/* vao_test.cpp
+
+This module tests VAO attribute setup:
+
+- bind_layout from batched buffer: flag 1;
+- bind_layout from compound buffer (matching by name): flag 2;
+- enabled arrays tracking: flag 4;
+- separate attribute format and vertex buffer bindings: flag 8;
+- element buffer recorded in the VAO state: flag 16;
+- separate attribute format of batched layout: flag 32;
+
+return code is a bitmask of flags set for each failed case;
+*/
+
+#include "gl_traits.hpp"
+#include "helpers.h"
+
+#include "glt_Common.h"
+
+using VAOnanosuit = glt::VAO<attrPosXYZ_vec3, attrNormals_vec3, attrTexCoords_vec3>;
+
+GLint AttribParam(GLuint indx, GLenum param)
+{
+	GLint val = 0;
+	glGetVertexAttribiv(indx, param, &val);
+	return val;
+}
+
+void test_batched(int& mask)
+{
+	glt::Buffer<glm::vec3, glm::vec2> buffer;
+	buffer.Bind(glt::BufferTarget::array);
+	buffer.AllocateMemory(10, 10, glt::BufUsage::static_draw);
+
+	VAO_vshader vao;
+	glt::bind_layout(vao, buffer);
+
+	if (!AttribParam(0, GL_VERTEX_ATTRIB_ARRAY_ENABLED) ||
+		!AttribParam(1, GL_VERTEX_ATTRIB_ARRAY_ENABLED) ||
+		AttribParam(0, GL_VERTEX_ATTRIB_ARRAY_SIZE) != 3 ||
+		AttribParam(1, GL_VERTEX_ATTRIB_ARRAY_SIZE) != 2 ||
+		AttribParam(1, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING) !=
+		(GLint)glt::handle_accessor(buffer.Handle()))
+		mask |= 1;
+
+	vao.UnBind();
+	buffer.UnBind();
+}
+
+void test_compound(int& mask)
+{
+	// normals are declared first, attributes are matched by names
+	glt::Buffer<glt::compound<attrNormals_vec3, attrTexCoords_vec3, attrPosXYZ_vec3>> buffer;
+	buffer.Bind(glt::BufferTarget::array);
+	buffer.AllocateMemory(10, glt::BufUsage::static_draw);
+
+	VAOnanosuit vao;
+	glt::bind_layout(vao, buffer);
+
+	GLint stride = (GLint)(sizeof(glm::vec3) * 3);
+
+	GLint offsets[3]{ 0 };
+	for (GLuint i = 0; i != 3; ++i)
+	{
+		void *ptr = nullptr;
+		glGetVertexAttribPointerv(i, GL_VERTEX_ATTRIB_ARRAY_POINTER, &ptr);
+		offsets[i] = (GLint)(std::ptrdiff_t)ptr;
+
+		if (AttribParam(i, GL_VERTEX_ATTRIB_ARRAY_STRIDE) != stride)
+			mask |= 2;
+	}
+
+	if (offsets[0] != (GLint)(2 * sizeof(glm::vec3)) ||
+		offsets[1] != 0 ||
+		offsets[2] != (GLint)sizeof(glm::vec3))
+		mask |= 2;
+
+	// arrays are already enabled
+	vao.EnablePointers();
+	if (!vao.ArrayEnabled(0) || !vao.ArrayEnabled(2))
+		mask |= 4;
+
+	vao.DisablePointer(glt::tag_t<attrNormals_vec3>());
+	if (vao.ArrayEnabled(1) || AttribParam(1, GL_VERTEX_ATTRIB_ARRAY_ENABLED))
+		mask |= 4;
+
+	vao.UnBind();
+	buffer.UnBind();
+}
+
+void test_separate_format(int& mask)
+{
+	glt::Buffer<glt::compound<attrPosXYZ_vec3, attrNormals_vec3, attrTexCoords_vec3>> mesh1, mesh2;
+
+	mesh1.Bind(glt::BufferTarget::array);
+	mesh1.AllocateMemory(10, glt::BufUsage::static_draw);
+	mesh2.Bind(glt::BufferTarget::array);
+	mesh2.AllocateMemory(20, glt::BufUsage::static_draw);
+	mesh2.UnBind();
+
+	// one VAO for all the meshes of the same vertex type
+	VAOnanosuit vao;
+	vao.Bind();
+	vao.SetCompoundFormat();
+	vao.EnablePointers();
+
+	if (AttribParam(2, GL_VERTEX_ATTRIB_RELATIVE_OFFSET) != (GLint)(2 * sizeof(glm::vec3)) ||
+		AttribParam(2, GL_VERTEX_ATTRIB_BINDING) != 0)
+		mask |= 8;
+
+	GLint bound = 0;
+
+	vao.BindVertexBuffer(glt::tag_s<0>(), mesh1());
+	glGetIntegeri_v(GL_VERTEX_BINDING_BUFFER, 0, &bound);
+	if (bound != (GLint)glt::handle_accessor(mesh1.Handle()))
+		mask |= 8;
+
+	vao.BindVertexBuffer(glt::tag_s<0>(), mesh2(), 5);
+	glGetIntegeri_v(GL_VERTEX_BINDING_BUFFER, 0, &bound);
+	if (bound != (GLint)glt::handle_accessor(mesh2.Handle()))
+		mask |= 8;
+
+	glGetIntegeri_v(GL_VERTEX_BINDING_OFFSET, 0, &bound);
+	if (bound != (GLint)(5 * mesh2().elem_size))
+		mask |= 8;
+
+	vao.UnBind();
+}
+
+void test_separate_batched(int& mask)
+{
+	glt::Buffer<glm::vec3, glm::vec2> buffer;
+	buffer.Bind(glt::BufferTarget::array);
+	buffer.AllocateMemory(10, 10, glt::BufUsage::static_draw);
+	buffer.UnBind();
+
+	// attribute i is sourced from the binding point i
+	VAO_vshader vao;
+	vao.Bind();
+	vao.SetFormat();
+	vao.EnablePointers();
+
+	if (AttribParam(1, GL_VERTEX_ATTRIB_BINDING) != 1 ||
+		AttribParam(1, GL_VERTEX_ATTRIB_RELATIVE_OFFSET) != 0 ||
+		AttribParam(1, GL_VERTEX_ATTRIB_ARRAY_SIZE) != 2)
+		mask |= 32;
+
+	vao.BindVertexBuffers(buffer(), buffer(glt::tag_s<1>()));
+
+	GLint bound = 0,
+		offset = 0,
+		stride = 0;
+	glGetIntegeri_v(GL_VERTEX_BINDING_BUFFER, 1, &bound);
+	glGetIntegeri_v(GL_VERTEX_BINDING_OFFSET, 1, &offset);
+	glGetIntegeri_v(GL_VERTEX_BINDING_STRIDE, 1, &stride);
+
+	if (bound != (GLint)glt::handle_accessor(buffer.Handle()) ||
+		offset != (GLint)buffer(glt::tag_s<1>()).BufferOffset() ||
+		stride != (GLint)sizeof(glm::vec2))
+		mask |= 32;
+
+	vao.UnBind();
+}
+
+void test_element_buffer(int& mask)
+{
+	glt::Buffer<GLuint> elements;
+	elements.Bind(glt::BufferTarget::element_array);
+	elements.AllocateMemory(6, glt::BufUsage::static_draw);
+
+	VAO_vshader vao,
+		other;
+
+	vao.Bind();
+	vao.BindElementBuffer(elements);
+	other.Bind();
+
+	GLint bound = -1;
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &bound);
+	if (bound != 0)
+		mask |= 16;
+
+	// binding of the element buffer is restored with the VAO
+	glt::gl_state& state = glt::gl_state::Current();
+	vao.Bind();
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &bound);
+	if (bound != (GLint)glt::handle_accessor(elements.Handle()) ||
+		state.Buffer(glt::BufferTarget::element_array) != (GLuint)bound ||
+		vao.ElementCount() != 6)
+		mask |= 16;
+
+	// element buffer replaced while the VAO is bound is restored instead of the recorded one
+	{
+		glt::Buffer<GLuint> replaced;
+		replaced.Bind(glt::BufferTarget::element_array);
+		replaced.AllocateMemory(3, glt::BufUsage::static_draw);
+
+		other.Bind();
+		vao.Bind();
+		glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &bound);
+		if (bound != (GLint)glt::handle_accessor(replaced.Handle()) ||
+			state.Buffer(glt::BufferTarget::element_array) != (GLuint)bound ||
+			vao.ElementCount() != 0)
+			mask |= 16;
+
+		other.Bind();
+	}
+
+	// name of the deleted buffer may be reused, thus the binding is unknown
+	vao.Bind();
+	if (vao.ElementBuffer() != glt::gl_state::unknown ||
+		state.Buffer(glt::BufferTarget::element_array) != glt::gl_state::unknown)
+		mask |= 16;
+
+	vao.UnBind();
+}
+
+int main()
+{
+	SmartGLFW glfw{ 4, 4 };
+	SmartGLFWwindow window{ SCR_WIDTH, SCR_HEIGHT, "vao test" };
+	glfw.MakeContextCurrent(window);
+
+	glt::LoadOpenGL(glfw.GetOpenGLLoader());
+
+	int retMask = 0;
+
+	test_batched(retMask);
+	test_compound(retMask);
+	test_separate_format(retMask);
+	test_separate_batched(retMask);
+	test_element_buffer(retMask);
+
+	return retMask;
+}
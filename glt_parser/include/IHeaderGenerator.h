@@ -49,7 +49,9 @@ private:
 
 	static std::basic_ostream<char>& WriteVariableClassName(std::basic_ostream<char>&, const Variable& var);
 	static void WriteCommonHeaderHead(std::basic_ostream<char>&);
-	static void WriteCommonVariables(std::basic_ostream<char>&, const Container&);
+	static void WriteCommonVariables(std::basic_ostream<char>&, const Container&,
+		const std::vector<CRefISourceFile>&);
+	static int ExplicitLocation(const Variable& var, const std::vector<CRefISourceFile>&);
 	static void WriteShaderTypes(std::basic_ostream<char>&, const ISourceFile&, 
 		std::string_view namePredicate = std::string_view());
 
@@ -53,7 +53,7 @@ void IHeaderGenerator::GenerateCommonHeader()
 	commonHeader.clear();
 
 	WriteCommonHeaderHead(commonHeader);
-	WriteCommonVariables(commonHeader, vars_);
+	WriteCommonVariables(commonHeader, vars_, sources_);
 
 	try
 	{
@@ -84,6 +84,12 @@ void IHeaderGenerator::GenerateCommonHeader()
 			"static_assert(glt::has_type_v<" << 
 			var.name << '_' << var.typeGLSL << ">, \"" << 
 			var.name << '_' << var.typeGLSL << " glt_type assertion failed!\");\n";
+
+		int location = ExplicitLocation(var, sources_);
+		if (location >= 0)
+			commonHeader << "static_assert(glt::variable_traits_location<" <<
+				var.name << '_' << var.typeGLSL << "> == " << location << ", \"" <<
+				var.name << '_' << var.typeGLSL << " glt_location assertion failed!\");\n";
 	}
 
 }
@@ -132,20 +138,62 @@ void IHeaderGenerator::WriteCommonHeaderHead(std::basic_ostream<char>& file)
 		"#define GLSLT_TYPE(NAME, VAR_NAME2, TYPE) struct NAME\\\n"
 		"{TYPE glt_value;\\\n"
 		"constexpr static const char* glt_name(){ return #VAR_NAME2;}\\\n"
+		"using glt_type = TYPE;};\n\n"
+		"#define GLSLT_TYPE_LOC(NAME, VAR_NAME2, TYPE, LOC) struct NAME\\\n"
+		"{TYPE glt_value;\\\n"
+		"constexpr static const char* glt_name(){ return #VAR_NAME2;}\\\n"
+		"constexpr static int glt_location = LOC;\\\n"
 		"using glt_type = TYPE;};\n\n";
 	// TODO: write generation time, user, files and\or license, etc.
 }
 
 void IHeaderGenerator::WriteCommonVariables(std::basic_ostream<char>& file,
-	const Container& vars)
+	const Container& vars, const std::vector<CRefISourceFile>& sources)
 {
 	assert(file.good());
 	for (const Variable& var : vars)
 	{
-		file << "GLSLT_TYPE(";
-		WriteVariableClassName(file, var) <<  ", " <<
-			var.name << ", " << var.CppGlslType() << ")\n";
+		int location = ExplicitLocation(var, sources);
+		if (location < 0)
+		{
+			file << "GLSLT_TYPE(";
+			WriteVariableClassName(file, var) << ", " <<
+				var.name << ", " << var.CppGlslType() << ")\n";
+			continue;
+		}
+
+		file << "GLSLT_TYPE_LOC(";
+		WriteVariableClassName(file, var) << ", " <<
+			var.name << ", " << var.CppGlslType() << ", " << location << ")\n";
+	}
+}
+
+/* Explicit location of a uniform (layout (location = N) uniform ...).
+Location is written to glt_Common.h only if all the sources declaring the uniform agree on it,
+otherwise it is queried at link time.
+*/
+int IHeaderGenerator::ExplicitLocation(const Variable& var,
+	const std::vector<CRefISourceFile>& sources)
+{
+	int location = -1;
+	for (const ISourceFile& sf : sources)
+	{
+		size_t vars = sf.VarsCount();
+		for (size_t i = 0; i != vars; ++i)
+		{
+			const Variable& other = sf.GetVariable(i);
+			if (!(other == var))
+				continue;
+
+			if (other.type != Variable::uniform || other.location < 0 ||
+				(location >= 0 && other.location != location))
+				return -1;
+
+			location = other.location;
+		}
 	}
+
+	return location;
 }
 
 void IHeaderGenerator::WriteShaderTypes(std::basic_ostream<char>& file, const ISourceFile & sf,
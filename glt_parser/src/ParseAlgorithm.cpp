@@ -25,6 +25,7 @@ struct glsl_variable_info
 		m_vertex_loc_in_type = m_layout | m_location | m_in,
 		m_vertex_in_type = m_layout | m_in,
 		m_uniform_loc_type = m_uniform | m_location,
+		m_uniform_layout_loc_type = m_layout | m_uniform | m_location,
 		m_uniform_type = m_uniform,
 		m_var_in_type = m_in,
 		m_var_out_type = m_out;
@@ -60,6 +61,7 @@ struct glsl_variable_info
 			return Variable::VarType::var_in;
 		case m_uniform_type:
 		case m_uniform_loc_type:
+		case m_uniform_layout_loc_type:
 			return Variable::VarType::uniform;
 		case m_vertex_in_type:
 		case m_vertex_loc_in_type:
@@ -87,6 +89,7 @@ struct glsl_variable_info
 			return Variable::VarType::var_in;
 		case m_uniform_type:
 		case m_uniform_loc_type:
+		case m_uniform_layout_loc_type:
 			return Variable::VarType::uniform;
 		case m_vertex_in_type:
 		case m_vertex_loc_in_type:
@@ -127,15 +130,18 @@ template<>
 std::vector<Variable> ParseAlgorithm<ShaderFileInfo::text_source>::ParseImpl(std::string_view shaderSource)
 {
 	std::vector<Variable> out;
+	// layout (location = N) may precede uniform, in or out qualifiers
 	static std::regex regVarGLSL
 	{
-		R"((?:(layout)\s+|(uniform)\s+)?)"
-		R"((?:[(]location\s*=\s*(\d+)\s*[)]\s+)?)"
-		R"((?:(in)\s+|(out)\s+)?)"
+		R"((?:(layout)\s*(?:[(]\s*location\s*=\s*(\d+)\s*[)])?\s*)?)"
+		R"((?:(uniform)\s+|(in)\s+|(out)\s+)?)"
 		R"((\w+)\s+)"
 		R"((\w+)\s*;)"
 	};
 
+	// submatches of the qualifiers in the order of glsl_variable_info slots
+	constexpr static size_t slotSubmatch[glsl_variable_info::layout_slots] = { 1, 3, 2, 4, 5 };
+
 	static size_t subs = regVarGLSL.mark_count() + 1;
 
 	std::regex_iterator<std::string_view::iterator> start{ shaderSource.cbegin(),
@@ -152,11 +158,11 @@ std::vector<Variable> ParseAlgorithm<ShaderFileInfo::text_source>::ParseImpl(std
 		bool pat[glsl_variable_info::layout_slots];
 
 		const std::match_results<std::string_view::const_iterator>& sm = *start;
-		auto iter = ++sm.cbegin();
 
 		for (size_t i = 0; i != glsl_variable_info::layout_slots; ++i)
-			pat[i] = (iter++)->matched;
+			pat[i] = sm[slotSubmatch[i]].matched;
 
+		auto iter = std::next(sm.cbegin(), glsl_variable_info::layout_slots + 1);
 		auto &type = (iter++)->str(),
 			&name = (iter++)->str();
 
@@ -165,7 +171,7 @@ std::vector<Variable> ParseAlgorithm<ShaderFileInfo::text_source>::ParseImpl(std
 		try
 		{
 			if (pat[2])
-				location = std::stoi(sm[3].str());
+				location = std::stoi(sm[2].str());
 		}
 		catch (...)
 		{